@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    AlignedAllocator.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <cstddef>
+#include <new>
+
+constexpr size_t cacheLineBytes = 64;
+
+// std allocator that starts every block on an Alignment boundary, so offsets computed with that
+// alignment in mind (see Runner's field layout) really do land on cache lines
+template <typename T, size_t Alignment = cacheLineBytes>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    BranchPool.cpp
+
+  ==============================================================================
+*/
+
+#include "BranchPool.h"
+#include <thread>
+#include "RealtimeCheck.h"
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+static inline void spinPause() noexcept {
+#if defined(_M_X64) || defined(__x86_64__)
+    _mm_pause();
+#endif
+}
+
+BranchPool::~BranchPool()
+{
+    stop();
+}
+
+void BranchPool::start(int numWorkers)
+{
+    stop();
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this));
+        workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void BranchPool::stop()
+{
+    for (auto& worker : workers) worker->signalThreadShouldExit();
+    for (auto& worker : workers) worker->stopThread(1000);
+    workers.clear();
+}
+
+void BranchPool::run(TaskFn fn, void* context, int count) noexcept
+{
+    REALTIME_SITE();
+    if (count <= 0) return;
+    taskFn.store(fn, std::memory_order_relaxed);
+    taskContext.store(context, std::memory_order_relaxed);
+    numTasks.store(count, std::memory_order_relaxed);
+    tasksDone.store(0, std::memory_order_relaxed);
+    const uint64_t job = (claim.load(std::memory_order_relaxed) >> 32) + 1;
+    claim.store(job << 32, std::memory_order_release);
+
+    work(job);
+    while (tasksDone.load(std::memory_order_acquire) < count) spinPause();
+}
+
+void BranchPool::work(uint64_t job) noexcept
+{
+    uint64_t current = claim.load(std::memory_order_acquire);
+    for (;;) {
+        if ((current >> 32) != job) return;
+        const int task = (int)(uint32_t)current;
+        if (task >= numTasks.load(std::memory_order_relaxed)) return;
+        if (!claim.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire)) continue;
+        taskFn.load(std::memory_order_relaxed)(taskContext.load(std::memory_order_relaxed), task);
+        tasksDone.fetch_add(1, std::memory_order_release);
+        current = claim.load(std::memory_order_acquire);
+    }
+}
+
+void BranchPool::Worker::run()
+{
+    REALTIME_AUDIO_SCOPE();
+    uint64_t lastJob = pool.claim.load(std::memory_order_acquire) >> 32;
+    int idle = 0;
+    while (!threadShouldExit()) {
+        const uint64_t job = pool.claim.load(std::memory_order_acquire) >> 32;
+        if (job != lastJob) {
+            lastJob = job;
+            pool.work(job);
+            idle = 0;
+            continue;
+        }
+        ++idle;
+        if (idle < spinRounds) spinPause();
+        else if (idle < yieldRounds) std::this_thread::yield();
+        else wait(1);
+    }
+}
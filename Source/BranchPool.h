@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    BranchPool.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// a few threads started ahead of playback that take the independent branches of a frame off the audio
+// thread (see RunnerInput::frameTasks). run hands them a job through one atomic and never waits on a
+// worker in particular: the audio thread claims tasks like any worker, so a worker that dozed off only
+// costs parallelism, never a deadline. nothing in run allocates or locks.
+// idle workers spin, then yield, then sleep, so a stopped transport doesn't hold cores
+class BranchPool {
+public:
+    using TaskFn = void(*)(void* context, int task);
+
+    BranchPool() = default;
+    ~BranchPool();
+
+    // message thread. start replaces whatever workers were running
+    void start(int numWorkers);
+    void stop();
+    int getNumWorkers() const noexcept { return (int)workers.size(); }
+
+    // audio thread. calls fn(context, t) for every t in [0, numTasks) across the workers and the caller,
+    // returns once all of them are done
+    void run(TaskFn fn, void* context, int numTasks) noexcept;
+
+private:
+    class Worker : public juce::Thread {
+    public:
+        explicit Worker(BranchPool& p) : juce::Thread("branch worker"), pool(p) {}
+        void run() override;
+    private:
+        BranchPool& pool;
+    };
+
+    void work(uint64_t job) noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    // job number in the high half, next unclaimed task in the low half. a claim only lands while its
+    // job is still the current one, so a worker late from the last job can't take a task of this one
+    alignas(64) std::atomic<uint64_t> claim{ 0 };
+    alignas(64) std::atomic<int> tasksDone{ 0 };
+    std::atomic<TaskFn> taskFn{ nullptr };
+    std::atomic<void*> taskContext{ nullptr };
+    std::atomic<int> numTasks{ 0 };
+
+    static constexpr int spinRounds = 4096;   // about the gap between two frames
+    static constexpr int yieldRounds = 65536; // a few blocks, then sleep until the transport is back
+};
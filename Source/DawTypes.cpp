@@ -45,8 +45,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistryDaw() {
                 }
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { const int p = (int)i0[k].i; o[k].d = p >= 0 && p < 1024 ? (float)u->dawParams[p] : 0.0; }");
+        t.inputReads = readsHostValues;
         t.outputType = InputType::decimal;
         t.alwaysOutputsRuntimeData = true;
+        t.isBlockRate = true;
         t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    Envelope.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <stdint.h>
+#include "ddtype.h"
+#include "StringifyDefines.h"
+
+// the ADSR envelope as a state machine per note, kept by the node in field (NodeType::stateSize): a
+// header of what the segments were worked out for (set, A, D, S, R, sample rate), then per note its
+// level, step per frame, frames left in the segment (this one included), and the frame, note start and
+// note end it was last ticked at. a tick within a segment is one add, the segment is worked out again
+// from the note's frame counters at its end, or when a tick doesn't follow on from the last one
+#define ENVELOPE_HEADER 6
+#define ENVELOPE_PER_NOTE 6
+#define ENVELOPE_STATE_SIZE (ENVELOPE_HEADER + ENVELOPE_PER_NOTE * 128)
+
+// defined in JIT kernels as well, MidiTypes' envelope emits calls to them. they reach kernels as text,
+// so the layout above is spelled out in numbers in here
+DEFINE_AND_CREATE_VAR(
+static inline double Envelope_ceil(double x) {
+    const double whole = (double)(int64_t)x;
+    return whole < x ? whole + 1.0 : whole;
+}
+
+static inline void Envelope_held(ddtype* e, double attack, double decay, double S, double heldFrames) {
+    if (heldFrames < attack) {
+        e[0].d = heldFrames / attack;
+        e[1].d = 1.0 / attack;
+        e[2].d = Envelope_ceil(attack - heldFrames);
+    }
+    else if (heldFrames < attack + decay) {
+        e[0].d = 1.0 - (heldFrames - attack) / decay * (1.0 - S);
+        e[1].d = -(1.0 - S) / decay;
+        e[2].d = Envelope_ceil(attack + decay - heldFrames);
+    }
+    else {
+        e[0].d = S;
+        e[1].d = 0.0;
+        e[2].d = 1e18;
+    }
+}
+
+static inline void Envelope_segment(ddtype* e, double attack, double decay, double S, double release, int held, double tOn, double tOff, double frame) {
+    e[0].d = 0.0;
+    e[1].d = 0.0;
+    e[2].d = 1.0;
+    if (held) {
+        if (frame - tOn > 0.0) Envelope_held(e, attack, decay, S, frame - tOn);
+        return;
+    }
+    if (tOff - tOn <= 0.0) {
+        e[2].d = 1e18;
+        return;
+    }
+    if (frame < tOff) return;
+    Envelope_held(e, attack, decay, S, tOff - tOn);
+    const double level = e[0].d;
+    const double released = frame - tOff;
+    e[1].d = 0.0;
+    e[2].d = 1.0;
+    if (released <= 0.0) return;
+    if (released < release) {
+        e[0].d = level * (1.0 - released / release);
+        e[1].d = -level / release;
+        e[2].d = Envelope_ceil(release - released);
+    }
+    else {
+        e[0].d = 0.0;
+        e[2].d = 1e18;
+    }
+}
+
+static inline int Envelope_begin(ddtype* state, double A, double D, double S, double R, double sr) {
+    const int fresh = state[0].d != 0.0 && state[1].d == A && state[2].d == D && state[3].d == S && state[4].d == R && state[5].d == sr;
+    state[0].d = 1.0;
+    state[1].d = A;
+    state[2].d = D;
+    state[3].d = S;
+    state[4].d = R;
+    state[5].d = sr;
+    return fresh;
+}
+
+static inline double Envelope_tick(ddtype* state, int n, int fresh, int held, double tOn, double tOff, double frame) {
+    ddtype* e = state + 6 + 6 * n;
+    if (fresh && e[3].d + 1.0 == frame && e[4].d == tOn && e[5].d == tOff && e[2].d > 1.0) {
+        e[0].d += e[1].d;
+        e[2].d -= 1.0;
+    }
+    else {
+        const double sr = state[5].d;
+        Envelope_segment(e, state[1].d * sr, state[2].d * sr, state[3].d, state[4].d * sr, held, tOn, tOff, frame);
+        e[4].d = tOn;
+        e[5].d = tOff;
+    }
+    e[3].d = frame;
+    return e[0].d < 0.0 ? 0.0 : e[0].d > 1.0 ? 1.0 : e[0].d;
+}
+, EnvelopeClang
+);
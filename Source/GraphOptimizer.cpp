@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+    GraphOptimizer.cpp
+
+  ==============================================================================
+*/
+
+#include "GraphOptimizer.h"
+#include "NodeData.h"
+#include "NodeType.h"
+#include "RunnerInput.h"
+#include "SceneData.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+// random sources have to stay separate, even a sub-scene containing one
+static bool isDeterministic(const NodeType* type, int depth = 0) {
+    if (type->isNondeterministic) return false;
+    if (!type->fromScene) return true;
+    if (depth > 16) return false; // recursive custom nodes, don't bother
+    for (auto& node : type->fromScene->nodeDatas) {
+        if (!isDeterministic(node->getType(), depth + 1)) return false;
+    }
+    return true;
+}
+
+static bool canMerge(const RunnerInput& input, const NodeData* node) {
+    return node != input.outputNode
+        && !node->isLive() // each has its own slot
+        && node->optionalStoredAudio.empty()
+        && isDeterministic(node->getType());
+}
+
+static size_t hashNode(const NodeData* node) {
+    size_t h = std::hash<const void*>()(node->getType());
+    auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+    for (int i = 0; i < node->getNumInputs(); ++i) {
+        const NodeData* in = node->getInput(i);
+        mix(in ? std::hash<const void*>()(in) : std::hash<int64_t>()(node->defaultValues[i].i));
+    }
+    for (auto& [key, value] : node->getProperties()) {
+        mix(std::hash<std::string>()(key));
+        mix(std::hash<std::string>()(value));
+    }
+    for (auto& [key, value] : node->getNumericProperties()) {
+        mix(std::hash<std::string>()(key));
+        mix(std::hash<double>()(value));
+    }
+    mix(std::hash<int>()(node->inputIndex));
+    return h;
+}
+
+static bool sameNode(const NodeData* a, const NodeData* b) {
+    if (a->getType() != b->getType() || a->inputIndex != b->inputIndex || a->getTrueType() != b->getTrueType()) return false;
+    for (int i = 0; i < a->getNumInputs(); ++i) {
+        if (a->getInput(i) != b->getInput(i)) return false;
+        if (!a->getInput(i) && a->defaultValues[i].i != b->defaultValues[i].i) return false;
+    }
+    return a->getProperties() == b->getProperties() && a->getNumericProperties() == b->getNumericProperties();
+}
+
+std::vector<NodeData*> GraphOptimizer::reachableFromOutput(const RunnerInput& input) {
+    std::vector<NodeData*> order;
+    if (!input.outputNode) return order;
+
+    // iterative post-order, scenes can get deep enough to worry about the stack
+    std::unordered_set<NodeData*> visited;
+    std::vector<std::pair<NodeData*, int>> stack;
+    stack.push_back({ input.outputNode, 0 });
+    visited.insert(input.outputNode);
+    while (!stack.empty()) {
+        auto& [node, next] = stack.back();
+        if (next < node->getNumInputs()) {
+            NodeData* in = node->getInput(next++);
+            if (in && visited.insert(in).second) {
+                stack.push_back({ in, 0 });
+            }
+        }
+        else {
+            order.push_back(node);
+            stack.pop_back();
+        }
+    }
+    return order;
+}
+
+int GraphOptimizer::mergeDuplicateNodes(RunnerInput& input) {
+    int merged = 0;
+    std::unordered_map<size_t, std::vector<NodeData*>> buckets;
+    std::unordered_map<NodeData*, std::vector<std::pair<NodeData*, int>>> consumers;
+    for (auto& copy : input.nodeCopies) {
+        for (int i = 0; i < copy->getNumInputs(); ++i) {
+            if (NodeData* in = copy->getInput(i)) consumers[in].push_back({ copy.get(), i });
+        }
+    }
+
+    // inputs come first, so by the time a node is hashed its inputs already point at survivors
+    for (NodeData* node : reachableFromOutput(input)) {
+        if (!canMerge(input, node)) continue;
+        auto& bucket = buckets[hashNode(node)];
+        auto match = std::find_if(bucket.begin(), bucket.end(), [node](NodeData* other) { return sameNode(node, other); });
+        if (match == bucket.end()) {
+            bucket.push_back(node);
+            continue;
+        }
+
+        NodeData* survivor = *match;
+        for (auto& [consumer, idx] : consumers[node]) {
+            if (consumer->inputNodes[idx] != node) continue;
+            consumer->inputNodes[idx] = survivor;
+            node->outputs.erase({ consumer, idx });
+            survivor->outputs.insert({ consumer, idx });
+            consumers[survivor].push_back({ consumer, idx });
+        }
+        // the editor's node behind the merged copy now reads its size off the survivor
+        if (auto it = input.remap.find(node); it != input.remap.end() && it->second) {
+            input.remap[it->second] = survivor;
+        }
+        ++merged;
+    }
+    return merged;
+}
+
+int GraphOptimizer::removeDeadNodes(RunnerInput& input) {
+    auto live = reachableFromOutput(input);
+    std::unordered_set<NodeData*> keep(live.begin(), live.end());
+    if (keep.size() == input.nodeCopies.size()) return 0;
+
+    for (auto& copy : input.nodeCopies) {
+        if (keep.contains(copy.get())) continue;
+        NodeData* dead = copy.get();
+        for (int i = 0; i < dead->getNumInputs(); ++i) {
+            if (NodeData* in = dead->getInput(i)) in->outputs.erase({ dead, i });
+        }
+        if (auto it = input.remap.find(dead); it != input.remap.end()) {
+            NodeData* sceneNode = it->second;
+            input.remap.erase(it);
+            auto back = input.remap.find(sceneNode);
+            if (back != input.remap.end() && back->second == dead) input.remap.erase(back);
+        }
+    }
+
+    const int before = (int)input.nodeCopies.size();
+    std::erase_if(input.nodeCopies, [&keep](const std::unique_ptr<NodeData>& copy) { return !keep.contains(copy.get()); });
+    return before - (int)input.nodeCopies.size();
+}
+
+// ---- peephole kernels, same signature as NodeType::execute ----
+
+static void squareKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) out[i].d = in[0][i].d * in[0][i].d;
+}
+
+static void cubeKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) { const double a = std::abs(in[0][i].d); out[i].d = a * a * a; }
+}
+
+static void sqrtKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) out[i].d = std::sqrt(std::abs(in[0][i].d));
+}
+
+static void absKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) out[i].d = std::abs(in[0][i].d);
+}
+
+static void onesKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) out[i].d = 1.0;
+}
+
+// in[1] holds 1 / ln(b), or 0 for a base with no logarithm
+static void scaledLogKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    const double k = in[1][0].d;
+    for (size_t i = 0; i < in[0].size(); ++i) {
+        const double v = in[0][i].d;
+        out[i].d = (v > 0.0 && k != 0.0) ? std::log(v) * k : 0.0;
+    }
+}
+
+// x / c with in[1] already holding 1 / c, one per op_mode so the mode isn't looked up per call
+static void multiplyPadKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    const size_t n = std::min(in[0].size(), in[1].size());
+    for (size_t i = 0; i < n; ++i) out[i].d = in[0][i].d * in[1][i].d;
+    for (size_t i = n; i < in[0].size(); ++i) out[i] = in[0][i]; // c is never the longer one here
+}
+
+static void multiplyTruncKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    const size_t n = std::min(in[0].size(), in[1].size());
+    for (size_t i = 0; i < n; ++i) out[i].d = in[0][i].d * in[1][i].d;
+}
+
+static void multiplyOuterKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    size_t k = 0;
+    for (size_t i = 0; i < in[0].size(); ++i)
+        for (size_t j = 0; j < in[1].size(); ++j)
+            out[k++].d = in[0][i].d * in[1][j].d;
+}
+
+// the fused step's last input is the partner's output
+static void sinCosKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) { out[i].d = std::sin(in[0][i].d); in.back()[i].d = std::cos(in[0][i].d); }
+}
+
+static void cosSinKernel(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
+    for (size_t i = 0; i < in[0].size(); ++i) { out[i].d = std::cos(in[0][i].d); in.back()[i].d = std::sin(in[0][i].d); }
+}
+
+std::string GraphOptimizer::emitKernel(decltype(PlanStep::execute) kernel) {
+    if (kernel == squareKernel) return "for (int k = 0; k < isize0; ++k) o[k].d = i0[k].d * i0[k].d;";
+    if (kernel == cubeKernel) return "for (int k = 0; k < isize0; ++k) { const double a = fabs(i0[k].d); o[k].d = a * a * a; }";
+    if (kernel == sqrtKernel) return "for (int k = 0; k < isize0; ++k) o[k].d = sqrt(fabs(i0[k].d));";
+    if (kernel == absKernel) return "for (int k = 0; k < isize0; ++k) o[k].d = fabs(i0[k].d);";
+    if (kernel == onesKernel) return "for (int k = 0; k < isize0; ++k) o[k].d = 1.0;";
+    if (kernel == scaledLogKernel) {
+        return "{ const double s = i1[0].d;"
+            " for (int k = 0; k < isize0; ++k) { const double v = i0[k].d; o[k].d = (v > 0.0 && s != 0.0) ? log(v) * s : 0.0; } }";
+    }
+    if (kernel == multiplyPadKernel) {
+        return "{ const int n = isize0 < isize1 ? isize0 : isize1;"
+            " for (int k = 0; k < n; ++k) o[k].d = i0[k].d * i1[k].d;"
+            " for (int k = n; k < isize0; ++k) o[k] = i0[k]; }";
+    }
+    if (kernel == multiplyTruncKernel) {
+        return "{ const int n = isize0 < isize1 ? isize0 : isize1; for (int k = 0; k < n; ++k) o[k].d = i0[k].d * i1[k].d; }";
+    }
+    if (kernel == multiplyOuterKernel) {
+        return "for (int a = 0; a < isize0; ++a) for (int b = 0; b < isize1; ++b) o[a * isize1 + b].d = i0[a].d * i1[b].d;";
+    }
+    if (kernel == sinCosKernel) return "for (int k = 0; k < isize0; ++k) { o[k].d = sin(i0[k].d); p[k].d = cos(i0[k].d); }";
+    if (kernel == cosSinKernel) return "for (int k = 0; k < isize0; ++k) { o[k].d = cos(i0[k].d); p[k].d = sin(i0[k].d); }";
+    return "";
+}
+
+// a compile-time known (or unconnected) operand as doubles, empty if it's only known at runtime
+static std::vector<double> constantOperand(const RunnerInput& input, NodeData* node, int i) {
+    NodeData* producer = node->getInput(i);
+    if (!producer) return { node->defaultValues[i].d };
+    if (!input.compileTimeKnown.contains(producer)) return {};
+
+    InputType type = producer->getType()->outputType;
+    if (type == InputType::followsInput) type = producer->getTrueType();
+    auto [offset, size] = input.safeOwnership.at(producer);
+    std::vector<double> values;
+    for (int k = 0; k < size; ++k) {
+        const ddtype v = input.field[offset + k];
+        values.push_back(type == InputType::decimal ? v.d : (double)v.i);
+    }
+    return values;
+}
+
+static bool allEqual(const std::vector<double>& values, double x) {
+    return !values.empty() && std::all_of(values.begin(), values.end(), [x](double v) { return v == x; });
+}
+
+// points everything reading node at replacement instead
+static void bypass(NodeData* node, NodeData* replacement) {
+    auto outputs = node->outputs;
+    for (auto& [consumer, idx] : outputs) {
+        if (!consumer || !consumer->isCopy || consumer->getInput(idx) != node) continue;
+        consumer->inputNodes[idx] = replacement;
+        node->outputs.erase({ consumer, idx });
+        replacement->outputs.insert({ consumer, idx });
+    }
+}
+
+static int appendConstant(RunnerInput& input, const std::vector<double>& values) {
+    const int offset = (int)input.field.size();
+    for (double v : values) input.field.push_back(v);
+    return offset;
+}
+
+std::unordered_map<NodeData*, PlanRewrite> GraphOptimizer::simplify(RunnerInput& input) {
+    std::unordered_map<NodeData*, PlanRewrite> rewrites;
+    std::unordered_map<NodeData*, NodeData*> sinOf, cosOf; // by input, waiting for a partner
+    auto count = [&input](const char* rule) { input.rewriteCounts[rule] += 1; };
+    auto runtimeOperand = [&input](NodeData* node, int i) -> NodeData* {
+        NodeData* p = node->getInput(i);
+        return p && !input.compileTimeKnown.contains(p) ? p : nullptr;
+    };
+    auto sizeOf = [&input](NodeData* node) { return std::get<1>(input.safeOwnership.at(node)); };
+
+    for (NodeData* node : input.nodesOrder) {
+        const auto& name = node->getType()->name;
+        if (input.compileTimeKnown.contains(node) || rewrites.contains(node)) continue;
+
+        if (name == "multiply" || name == "add" || name == "subtract" || name == "divide") {
+            const bool scales = name == "multiply" || name == "divide";
+            const bool commutative = name == "multiply" || name == "add";
+            const int mode = (int)node->getNumericProperty("op_mode");
+            for (int side = 1; side >= (commutative ? 0 : 1); --side) {
+                NodeData* x = runtimeOperand(node, 1 - side);
+                auto c = constantOperand(input, node, side);
+                if (!x || c.empty()) continue;
+
+                if (allEqual(c, scales ? 1.0 : 0.0) && sizeOf(node) == sizeOf(x)) {
+                    bypass(node, x);
+                    rewrites[node].skip = true;
+                    count(name == "multiply" ? "x*1" : name == "divide" ? "x/1" : name == "add" ? "x+0" : "x-0");
+                    break;
+                }
+                const bool noZeros = std::none_of(c.begin(), c.end(), [](double v) { return v == 0.0; });
+                if (name == "divide" && noZeros && (mode != 0 || (int)c.size() <= sizeOf(x))) {
+                    std::vector<double> reciprocal;
+                    for (double v : c) reciprocal.push_back(1.0 / v);
+                    auto& rewrite = rewrites[node];
+                    rewrite.execute = mode == 0 ? multiplyPadKernel : mode == 1 ? multiplyTruncKernel : multiplyOuterKernel;
+                    rewrite.constantInput = 1;
+                    rewrite.constantOffset = appendConstant(input, reciprocal);
+                    count("x/c -> x*(1/c)");
+                }
+                break;
+            }
+        }
+        else if (name == "pow" && runtimeOperand(node, 0)) {
+            auto y = constantOperand(input, node, 1);
+            if (y.empty()) continue;
+            decltype(PlanStep::execute) kernel = nullptr;
+            const char* rule = nullptr;
+            if (y[0] == 2.0) { kernel = squareKernel; rule = "pow(x,2) -> x*x"; }
+            else if (y[0] == 3.0) { kernel = cubeKernel; rule = "pow(x,3) -> |x|*|x|*|x|"; }
+            else if (y[0] == 0.5) { kernel = sqrtKernel; rule = "pow(x,0.5) -> sqrt(|x|)"; }
+            else if (y[0] == 1.0) { kernel = absKernel; rule = "pow(x,1) -> |x|"; }
+            else if (y[0] == 0.0) { kernel = onesKernel; rule = "pow(x,0) -> 1"; }
+            if (kernel) {
+                rewrites[node].execute = kernel;
+                count(rule);
+            }
+        }
+        else if (name == "log base b" && runtimeOperand(node, 0)) {
+            auto b = constantOperand(input, node, 1);
+            if (b.empty()) continue;
+            const double lb = (b[0] > 0.0 && b[0] != 1.0) ? std::log(b[0]) : 0.0;
+            auto& rewrite = rewrites[node];
+            rewrite.execute = scaledLogKernel;
+            rewrite.constantInput = 1;
+            rewrite.constantOffset = appendConstant(input, { lb != 0.0 ? 1.0 / lb : 0.0 });
+            count("log_b(x) -> ln(x)*(1/ln b)");
+        }
+        else if ((name == "sin" || name == "cos") && runtimeOperand(node, 0)) {
+            NodeData* x = node->getInput(0);
+            const bool isSin = name == "sin";
+            auto& partners = isSin ? cosOf : sinOf;
+            auto it = partners.find(x);
+            if (it == partners.end()) {
+                (isSin ? sinOf : cosOf).insert({ x, node });
+                continue;
+            }
+            // the earlier of the two does both, so it runs before anything reading either
+            NodeData* first = it->second;
+            partners.erase(it);
+            auto& rewrite = rewrites[first];
+            rewrite.execute = isSin ? cosSinKernel : sinCosKernel;
+            rewrite.fusedPartner = node;
+            rewrites[node].skip = true;
+            count("sin/cos pair -> one step");
+        }
+    }
+
+    return rewrites;
+}
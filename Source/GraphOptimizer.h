@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    GraphOptimizer.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "RunnerInput.h"
+
+// how Runner::initialize builds the step of a node the peephole pass rewrote
+struct PlanRewrite {
+    decltype(PlanStep::execute) execute = nullptr; // cheaper kernel, null keeps the type's own
+    int constantInput = -1;          // this input reads constantOffset in field instead of its producer
+    int constantOffset = -1;
+    NodeData* fusedPartner = nullptr; // sin/cos of the same input: the step also fills the partner's output
+    bool skip = false;               // no step at all, consumers were rewired or a fused step covers it
+};
+
+// passes over RunnerInput::nodeCopies, run by Runner::initialize. they only ever touch the copies,
+// the scene the user is editing stays as drawn
+class GraphOptimizer {
+public:
+    // hash-conses structurally identical nodes (same type, properties, defaults and inputs) into one
+    // and points their consumers at the survivor. returns how many nodes were merged away
+    static int mergeDuplicateNodes(class RunnerInput& input);
+    // drops every copy the output node doesn't depend on (merged nodes included). returns how many
+    static int removeDeadNodes(RunnerInput& input);
+
+    // peephole pass over the runtime nodes, after compile-time known ones have their values:
+    // x*1, x+0, x-0, x/1 are bypassed, pow with a constant exponent, x/c and log base b with a
+    // constant base get cheaper kernels, sin/cos of the same input share one step.
+    // counts per rule end up in RunnerInput::rewriteCounts
+    static std::unordered_map<NodeData*, PlanRewrite> simplify(RunnerInput& input);
+    // C for one of simplify's kernels, in the terms Runner::initializeClang sets up (p is the fused
+    // partner's output). empty for anything else
+    static std::string emitKernel(decltype(PlanStep::execute) kernel);
+
+    // every node the output depends on, inputs before the nodes that read them
+    static std::vector<class NodeData*> reachableFromOutput(const RunnerInput& input);
+};
@@ -44,6 +44,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryIntegral() {
                 n.inputGUIElements.back()->setBounds(sides, cornerSize, n.getWidth() - sides - sides, n.getHeight() - cornerSize * 2);
             }
             };
+        outputType.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k] = i0[k];");
         outputType.outputType = InputType::any;
         outputType.alwaysOutputsRuntimeData = false;
         outputType.fromScene = nullptr;
@@ -91,7 +92,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryIntegral() {
                 {
                     auto el = dynamic_cast<juce::TextEditor*>(comp.inputGUIElements.back().get());
                     node.setProperty("name", el->getText().toStdString());
-                    comp.getOwningScene()->onSceneChanged();
+                    comp.getOwningScene()->onSceneChanged(&node);
                 };
 
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
@@ -114,6 +115,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryIntegral() {
         back->setBounds(sides, cornerSize, comp.getWidth() - sides - sides, comp.getHeight() - cornerSize * 2);
         back->applyFontToAllText(back->getFont().withHeight(14 * scale));
         };
+    inputType.emitCode = emitFixed("for (int k = 0; k < osize; ++k) { if (k < isize0) o[k] = i0[k]; else o[k].d = 0.0; }");
     inputType.outputType = InputType::followsInput;
     inputType.alwaysOutputsRuntimeData = false;
     inputType.fromScene = nullptr;
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    KernelCache.cpp
+
+  ==============================================================================
+*/
+
+#include "KernelCache.h"
+#include <algorithm>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+
+KernelCache& KernelCache::get()
+{
+    static KernelCache cache;
+    return cache;
+}
+
+KernelCache::KernelCache()
+{
+    // next to the scene explorer's files, see SceneExplorerComponent::getAppDataRoot
+    directory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("waviate").getChildFile("waviate_flow").getChildFile("kernel_cache");
+    directory.createDirectory();
+}
+
+std::string KernelCache::keyFor(const std::string& sourceCode, const std::string& compileOptions)
+{
+    // FNV-1a, stable across runs and compilers unlike std::hash
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& s) {
+        for (unsigned char c : s) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xff; // separator, so ("ab", "c") and ("a", "bc") differ
+        hash *= 1099511628211ull;
+    };
+    mix(sourceCode);
+    mix(compileOptions);
+    mix(LLVM_VERSION_STRING);
+    return juce::String::toHexString((juce::int64)hash).paddedLeft('0', 16).toStdString();
+}
+
+juce::File KernelCache::fileFor(const std::string& key) const
+{
+    return directory.getChildFile(juce::String(key) + ".o");
+}
+
+std::unique_ptr<llvm::MemoryBuffer> KernelCache::load(const std::string& key)
+{
+    std::lock_guard<realtime::CheckedMutex> guard(lock);
+    juce::File file = fileFor(key);
+    if (!file.existsAsFile()) return nullptr;
+    auto buffer = llvm::MemoryBuffer::getFile(file.getFullPathName().toStdString());
+    if (!buffer) return nullptr;
+    file.setLastAccessTime(juce::Time::getCurrentTime()); // eviction goes by this
+    ++hits;
+    return std::move(*buffer);
+}
+
+void KernelCache::store(const std::string& key, llvm::MemoryBufferRef object)
+{
+    std::lock_guard<realtime::CheckedMutex> guard(lock);
+    // write next to it and rename, a half-written object must never be loadable
+    juce::File file = fileFor(key);
+    juce::TemporaryFile temp(file);
+    if (!temp.getFile().replaceWithData(object.getBufferStart(), object.getBufferSize())) return;
+    if (!temp.overwriteTargetFileWithTemporary()) return;
+    ++stores;
+    evict();
+}
+
+void KernelCache::evict()
+{
+    auto files = directory.findChildFiles(juce::File::findFiles, false, "*.o");
+    juce::int64 total = 0;
+    for (auto& f : files) total += f.getSize();
+    if (total <= maxBytes) return;
+
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b) {
+        return a.getLastAccessTime() < b.getLastAccessTime();
+    });
+    for (auto& f : files) {
+        if (total <= maxBytes) break;
+        total -= f.getSize();
+        f.deleteFile();
+    }
+}
+
+void KernelCache::notifyObjectCompiled(const llvm::Module* M, llvm::MemoryBufferRef Obj)
+{
+    const std::string& key = M->getModuleIdentifier();
+    if (!key.empty()) store(key, Obj);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> KernelCache::getObject(const llvm::Module* M)
+{
+    const std::string& key = M->getModuleIdentifier();
+    return key.empty() ? nullptr : load(key);
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    KernelCache.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "RealtimeCheck.h"
+
+// object files of JIT kernels, kept on disk across sessions. a kernel's key hashes its generated
+// source together with everything else that changes the machine code (opt level, triple, LLVM
+// version), so reopening a project or undoing back to a graph seen before loads the object instead
+// of going through clang and the pass pipeline again. the least recently used files go once the
+// directory outgrows maxBytes.
+// modules handed to the JIT must carry their key as module identifier, that's what ObjectCache
+// gets to see
+class KernelCache : public llvm::ObjectCache {
+public:
+    static KernelCache& get();
+
+    static std::string keyFor(const std::string& sourceCode, const std::string& compileOptions);
+
+    // the object stored under key, null on a miss
+    std::unique_ptr<llvm::MemoryBuffer> load(const std::string& key);
+    void store(const std::string& key, llvm::MemoryBufferRef object);
+
+    void notifyObjectCompiled(const llvm::Module* M, llvm::MemoryBufferRef Obj) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* M) override;
+
+    static constexpr juce::int64 maxBytes = 256 * 1024 * 1024;
+
+    // loads that found their object and objects written, since the process started
+    int getHits() const noexcept { return hits.load(); }
+    int getStores() const noexcept { return stores.load(); }
+
+private:
+    KernelCache();
+    juce::File fileFor(const std::string& key) const;
+    void evict();
+
+    juce::File directory;
+    realtime::CheckedMutex lock; // JIT compile threads only
+    std::atomic<int> hits{ 0 };
+    std::atomic<int> stores{ 0 };
+};
@@ -44,9 +44,11 @@
                 out[k++].d = OP(in[0][i], in[1][j]); \
     }
 
+constexpr int opModeSlot = 0; // propertySlots of the arithmetic ops
+
 #define MAKE_BIN_EXEC(OP) [](const NodeData& nd, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput& inlineInstance)\
 { \
-    int mode = (int)nd.getNumericProperty("op_mode");\
+    int mode = (int)nd.getSlot(opModeSlot);\
     if (mode == 0) {\
         EXEC_PAD(OP); \
     } else if (mode == 1) {\
@@ -56,6 +58,31 @@
     }\
 };
 
+// one kernel per op_mode, so the plan doesn't test the mode every sample
+#define MAKE_BIN_KERNEL(NAME, EXEC, OP) \
+    static void NAME(const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) \
+    EXEC(OP)
+
+#define MAKE_BIN_KERNELS(OPNAME, OP) \
+    MAKE_BIN_KERNEL(OPNAME##Pad, EXEC_PAD, OP) \
+    MAKE_BIN_KERNEL(OPNAME##Trunc, EXEC_TRUNC, OP) \
+    MAKE_BIN_KERNEL(OPNAME##Outer, EXEC_OUTER, OP)
+
+MAKE_BIN_KERNELS(add, OP_ADD)
+MAKE_BIN_KERNELS(sub, OP_SUB)
+MAKE_BIN_KERNELS(mul, OP_MUL)
+MAKE_BIN_KERNELS(div, OP_DIV)
+
+#define MAKE_BIN_SPECIALIZE(OPNAME) [](const NodeData& nd) -> NodeType::ExecuteFn \
+{ \
+    switch ((int)nd.getSlot(opModeSlot)) { \
+    case 0: return OPNAME##Pad; \
+    case 1: return OPNAME##Trunc; \
+    case 2: return OPNAME##Outer; \
+    } \
+    return nullptr; \
+}
+
 bool WaviateFlow2025AudioProcessor::supportsDoublePrecisionProcessing() const { return true; }
 
 void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
@@ -110,6 +137,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
         addType.buildUI = binaryOpBuildUI;
         addType.onResized = [](NodeComponent&) {};
         addType.execute = MAKE_BIN_EXEC(OP_ADD);
+        addType.propertySlots = { "op_mode" };
+        addType.specialize = MAKE_BIN_SPECIALIZE(add);
+        addType.emitCode = emitBinaryOp("a + b");
+        addType.laneWise = true;
         addType.outputType = InputType::decimal;
         addType.alwaysOutputsRuntimeData = false;
         addType.fromScene = nullptr;
@@ -129,6 +160,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
         subType.buildUI = binaryOpBuildUI;
         subType.onResized = [](NodeComponent&) {};
         subType.execute = MAKE_BIN_EXEC(OP_SUB);
+        subType.propertySlots = { "op_mode" };
+        subType.specialize = MAKE_BIN_SPECIALIZE(sub);
+        subType.emitCode = emitBinaryOp("a - b");
+        subType.laneWise = true;
         subType.outputType = InputType::decimal;
         subType.alwaysOutputsRuntimeData = false;
         subType.fromScene = nullptr;
@@ -147,6 +182,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
         mulType.buildUI = binaryOpBuildUI;
         mulType.onResized = [](NodeComponent&) {};
         mulType.execute = MAKE_BIN_EXEC(OP_MUL);
+        mulType.propertySlots = { "op_mode" };
+        mulType.specialize = MAKE_BIN_SPECIALIZE(mul);
+        mulType.emitCode = emitBinaryOp("a * b");
+        mulType.laneWise = true;
         mulType.outputType = InputType::decimal;
         mulType.alwaysOutputsRuntimeData = false;
         mulType.fromScene = nullptr;
@@ -164,6 +203,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
     divType.buildUI = binaryOpBuildUI;
     divType.onResized = [](NodeComponent&) {};
     divType.execute = MAKE_BIN_EXEC(OP_DIV);
+    divType.propertySlots = { "op_mode" };
+    divType.specialize = MAKE_BIN_SPECIALIZE(div);
+    divType.emitCode = emitBinaryOp("b == 0.0 ? 0.0 : a / b");
+    divType.laneWise = true;
     divType.outputType = InputType::decimal;
     divType.alwaysOutputsRuntimeData = false;
     divType.fromScene = nullptr;
@@ -186,6 +229,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                 const auto& x = in[0];
                 for (int i = 0; i < (int)x.size(); ++i) out[i] = (int64_t)x[i].d;
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k].i = (int64_t)i0[k].d;");
         t.outputType = InputType::integer; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
         // (No hotkey assigned)
@@ -207,6 +251,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                 const auto& x = in[0];
                 for (int i = 0; i < (int)x.size(); ++i) out[i] = (int64_t)std::floor(x[i].d);
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k].i = (int64_t)floor(i0[k].d);");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -227,6 +272,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                 const auto& x = in[0];
                 for (int i = 0; i < (int)x.size(); ++i) out[i] = (int64_t)std::ceil(x[i].d);
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k].i = (int64_t)ceil(i0[k].d);");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -251,6 +297,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                 const double y = in[1].empty() ? 1.0 : in[1][0].d;
                 for (int i = 0; i < (int)x.size(); ++i) out[i] = std::pow(std::abs(x[i].d), y);
             };
+        t.emitCode = emitFixed("{ const double y = isize1 == 0 ? 1.0 : i1[0].d; for (int k = 0; k < isize0; ++k) o[k].d = pow(fabs(i0[k].d), y); }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
         // Hotkey: caret (Shift+6)
@@ -283,6 +330,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i].d = std::pow(std::abs(xx), y);
                 }
             };
+        t.emitCode = emitFixed("{ const double y = isize1 == 0 ? 1.0 : i1[0].d; for (int k = 0; k < isize0; ++k) o[k].d = pow(fabs(i0[k].d), y); }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
         // Hotkey: caret (Shift+6)
@@ -314,6 +362,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i] = (v > 0.0 && lb != 0.0) ? (std::log(v) / lb) : 0.0;
                 }
             };
+        t.emitCode = emitFixed(R"(
+                const double b = isize1 == 0 ? 2.0 : i1[0].d;
+                const double lb = (b > 0.0 && b != 1.0) ? log(b) : 0.0;
+                for (int k = 0; k < isize0; ++k) { const double v = i0[k].d; o[k].d = (v > 0.0 && lb != 0.0) ? log(v) / lb : 0.0; }
+            )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -337,6 +390,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i] = (v > 0.0) ? std::log(v) : 0.0;
                 }
             };
+        t.emitCode = emitUnary("x > 0.0 ? log(x) : 0.0");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -360,6 +414,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i] = (c != 0.0) ? (1.0 / c) : 0.0;
                 }
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { const double c = cos(i0[k].d); o[k].d = c != 0.0 ? 1.0 / c : 0.0; }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -383,6 +438,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i] = (s != 0.0) ? (1.0 / s) : 0.0;
                 }
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { const double s = sin(i0[k].d); o[k].d = s != 0.0 ? 1.0 / s : 0.0; }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -406,6 +462,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMath() {
                     out[i].d = (t != 0.0) ? (1.0 / t) : 0.0;
                 }
             };
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { const double t = tan(i0[k].d); o[k].d = t != 0.0 ? 1.0 / t : 0.0; }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
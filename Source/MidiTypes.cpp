@@ -9,6 +9,34 @@
 */
 
 #include "Registry.h"
+#include "Envelope.h"
+
+// the envelope of every note in lanes, or of all 128 when lanes is null. in[4] is the node's state
+// (see Envelope.h), without it (a run at compile time) the envelope is silent
+static void envelopeLanes(UserInput& userInput, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const int* lanes, int numLanes)
+{
+    if (in.size() < 5 || in[4].size() < ENVELOPE_STATE_SIZE) {
+        std::fill(out.begin(), out.end(), ddtype(0.0));
+        return;
+    }
+    // Read scalar parameters (with sane clamps)
+    const double A = !in[0].empty() ? std::max(0.0, in[0][0].d) : 0.0;
+    const double D = !in[1].empty() ? std::max(0.0, in[1][0].d) : 0.0;
+    const double S = !in[2].empty() ? std::clamp(in[2][0].d, 0.0, 1.0) : 0.0;
+    const double R = !in[3].empty() ? std::max(0.0, in[3][0].d) : 0.0;
+
+    // Current time in frames
+    const double curFrame = (double)(userInput.numFramesStartOfBlock + userInput.sampleInBlock);
+    const double sr = (userInput.sampleRate > 0.0 ? userInput.sampleRate : 44100.0);
+
+    ddtype* state = in[4].data();
+    const int fresh = Envelope_begin(state, A, D, S, R, sr);
+    for (int l = 0; l < numLanes; ++l) {
+        const int n = lanes ? lanes[l] : l;
+        out[n] = Envelope_tick(state, n, fresh, userInput.notesOn[n] != 0.0,
+            userInput.noteStartFrame[n], userInput.noteEndFrame[n], curFrame);
+    }
+}
 
 void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
     NodeType::registryCreatePrefix = 400000;
@@ -38,6 +66,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
                 }
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k].d = 440.0 * pow(2.0, ((int)i0[k].i - 69) / 12.0);");
         t.outputType = InputType::decimal;
         t.alwaysOutputsRuntimeData = false;
         t.fromScene = nullptr;
@@ -73,8 +102,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
                 }
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { const int cc = (int)i0[k].i; o[k].d = cc >= 0 && cc < 128 ? (float)u->midiCCValues[cc] : 0.0; }");
+        t.inputReads = readsHostValues;
         t.outputType = InputType::decimal;
         t.alwaysOutputsRuntimeData = true;
+        t.isBlockRate = true;
         t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -95,8 +127,15 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
             }
 
         };
+    velocity.emitCode = emitFixed("for (int k = 0; k < 128; ++k) o[k].d = u->noteVelocity[k];");
+    velocity.executeActiveLanes = [](const NodeData&, UserInput& userInput, const std::vector<std::span<ddtype>>&, std::span<ddtype> output, const RunnerInput&)
+        {
+            for (int a = 0; a < userInput.numActiveLanes; ++a) output[userInput.activeLanes[a]] = userInput.noteVelocity[userInput.activeLanes[a]];
+        };
+    velocity.emitActiveLanes = emitFixed("for (int a = 0; a < u->numActiveLanes; ++a) { const int k = u->activeLanes[a]; o[k].d = u->noteVelocity[k]; }");
     velocity.outputType = InputType::decimal;
     velocity.alwaysOutputsRuntimeData = true;
+    velocity.isBlockRate = true;
     velocity.fromScene = nullptr;
     registry.push_back(velocity);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("shift v").getTextDescription(), registry.size() - 1 });
@@ -114,8 +153,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
         {
             output[0] = userInput.pitchWheelValue;
         };
+    pitchWheelType.emitCode = emitFixed("o[0].d = u->pitchWheelValue;");
     pitchWheelType.outputType = InputType::decimal;
     pitchWheelType.alwaysOutputsRuntimeData = true;
+    pitchWheelType.isBlockRate = true;
     pitchWheelType.fromScene = nullptr;
     registry.push_back(pitchWheelType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("p").getTextDescription(), registry.size() - 1 });
@@ -132,8 +173,15 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
         {
             for (int i = 0; i < 128; ++i) output[i] = userInput.notesOn[i];
         };
+    allNotesType.emitCode = emitFixed("for (int k = 0; k < 128; ++k) o[k].d = u->notesOn[k];");
+    allNotesType.executeActiveLanes = [](const NodeData&, UserInput& userInput, const std::vector<std::span<ddtype>>&, std::span<ddtype> output, const RunnerInput&)
+        {
+            for (int a = 0; a < userInput.numActiveLanes; ++a) output[userInput.activeLanes[a]] = userInput.notesOn[userInput.activeLanes[a]];
+        };
+    allNotesType.emitActiveLanes = emitFixed("for (int a = 0; a < u->numActiveLanes; ++a) { const int k = u->activeLanes[a]; o[k].d = u->notesOn[k]; }");
     allNotesType.outputType = InputType::boolean;
     allNotesType.alwaysOutputsRuntimeData = true;
+    allNotesType.isBlockRate = true;
     allNotesType.fromScene = nullptr;
     registry.push_back(allNotesType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("shift n").getTextDescription(), registry.size() - 1 });
@@ -150,6 +198,13 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
         {
             for (int i = 0; i < 128; ++i) output[i] = userInput.noteCycle[i];
         };
+    waveCycleType.emitCode = emitFixed("for (int k = 0; k < 128; ++k) o[k].d = u->noteCycle[k];");
+    waveCycleType.executeActiveLanes = [](const NodeData&, UserInput& userInput, const std::vector<std::span<ddtype>>&, std::span<ddtype> output, const RunnerInput&)
+        {
+            for (int a = 0; a < userInput.numActiveLanes; ++a) output[userInput.activeLanes[a]] = userInput.noteCycle[userInput.activeLanes[a]];
+        };
+    waveCycleType.emitActiveLanes = emitFixed("for (int a = 0; a < u->numActiveLanes; ++a) { const int k = u->activeLanes[a]; o[k].d = u->noteCycle[k]; }");
+    waveCycleType.inputReads = readsNoteCycles;
     waveCycleType.outputType = InputType::decimal;
     waveCycleType.alwaysOutputsRuntimeData = true;
     waveCycleType.fromScene = nullptr;
@@ -162,6 +217,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
     envelopeType.name = "envelope (ADSR)";
     envelopeType.address = "audio/midi/envelopes/";
     envelopeType.tooltip = "Per-note ADSR: outputs 128 values in [0,1] from note start/end and ADSR times.";
+    envelopeType.stateSize = ENVELOPE_STATE_SIZE;
     envelopeType.inputs = {
         // scalar controls (seconds for A/D/R; [0,1] for sustain)
         InputFeatures("attack (s)",  InputType::decimal, 1, false),
@@ -176,105 +232,44 @@ void WaviateFlow2025AudioProcessor::initializeRegistryMidi() {
     envelopeType.getOutputSize = outputSizeAllMidi;
     envelopeType.buildUI = [](NodeComponent&, NodeData&) {};
     envelopeType.onResized = [](NodeComponent&) {};
+    // head opens the loop over the notes and names the current one n
+    auto emitEnvelope = [](const std::string& head) {
+        return emitFixed(R"(
+            #define ENV_CLAMP(v, lo, hi) ((v) < (lo) ? (lo) : (hi) < (v) ? (hi) : (v))
+            const double A = isize0 > 0 && 0.0 < i0[0].d ? i0[0].d : 0.0;
+            const double D = isize1 > 0 && 0.0 < i1[0].d ? i1[0].d : 0.0;
+            const double S = isize2 > 0 ? ENV_CLAMP(i2[0].d, 0.0, 1.0) : 0.0;
+            const double R = isize3 > 0 && 0.0 < i3[0].d ? i3[0].d : 0.0;
+            const double curFrame = (double)(u->numFramesStartOfBlock + u->sampleInBlock);
+            const double sr = u->sampleRate > 0.0 ? u->sampleRate : 44100.0;
+            const int fresh = Envelope_begin(st, A, D, S, R, sr);
+            )" + head + R"(
+                o[n].d = Envelope_tick(st, n, fresh, u->notesOn[n] != 0.0, u->noteStartFrame[n], u->noteEndFrame[n], curFrame);
+            }
+            #undef ENV_CLAMP
+        )");
+    };
+    envelopeType.emitCode = emitEnvelope("for (int n = 0; n < 128; ++n) {");
+    envelopeType.emitActiveLanes = emitEnvelope("for (int a = 0; a < u->numActiveLanes; ++a) { const int n = u->activeLanes[a];");
     envelopeType.outputType = InputType::decimal;
     envelopeType.alwaysOutputsRuntimeData = true;
     envelopeType.fromScene = nullptr;
 
-    envelopeType.execute = [](
-        const NodeData&,
-        UserInput& userInput,
-        const std::vector<std::span<ddtype>>& in,
-        std::span<ddtype> out, const RunnerInput& inlineInstance)
+    envelopeType.execute = [](const NodeData&, UserInput& userInput, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&)
         {
-            // Read scalar parameters (with sane clamps)
-            const double A = (in.size() > 0 && !in[0].empty()) ? std::max(0.0, in[0][0].d) : 0.0;
-            const double D = (in.size() > 1 && !in[1].empty()) ? std::max(0.0, in[1][0].d) : 0.0;
-            const double S = (in.size() > 2 && !in[2].empty()) ? std::clamp(in[2][0].d, 0.0, 1.0) : 0.0;
-            const double R = (in.size() > 3 && !in[3].empty()) ? std::max(0.0, in[3][0].d) : 0.0;
-
-            // Current time in frames and seconds
-            const double curFrame = userInput.numFramesStartOfBlock + userInput.sampleInBlock;
-            const double sr = (userInput.sampleRate > 0.0 ? userInput.sampleRate : 44100.0);
-
-            // Helpers to avoid division by zero in linear ramps
-            auto linUp = [](double t, double T) -> double {
-                if (T <= 0.0) return 1.0;           // instantaneous to 1
-                return std::clamp(t / T, 0.0, 1.0); // 0 -> 1
-                };
-            auto linDownTo = [](double t, double T, double target) -> double {
-                // starts at 1.0 at t=0, linearly reaches target at t=T
-                if (T <= 0.0) return target;
-                double v = 1.0 - (t / T) * (1.0 - target);
-                return std::clamp(v, target, 1.0);
-                };
-            auto releaseFrom = [](double t, double T, double startVal) -> double {
-                if (T <= 0.0) return 0.0;
-                double v = startVal * (1.0 - t / T);
-                return std::clamp(v, 0.0, startVal);
-                };
-
-            // Compute per-note envelope
-            for (int n = 0; n < 128; ++n) {
-                const bool  on = (userInput.notesOn[n] != 0.0);
-                const double tOnF = userInput.noteStartFrame[n];
-                const double tOffF = userInput.noteEndFrame[n];
-
-                // Default
-                double env = 0.0;
-
-                if (on) {
-                    // NOTE IS HELD: time since key-down
-                    const double tHeldSec = (curFrame - tOnF) / sr;
-                    if (tHeldSec <= 0.0) {
-                        env = 0.0;
-                    }
-                    else if (tHeldSec < A) {
-                        // Attack: 0 -> 1
-                        env = linUp(tHeldSec, A);
-                    }
-                    else if (tHeldSec < A + D) {
-                        // Decay: 1 -> S
-                        env = linDownTo(tHeldSec - A, D, S);
-                    }
-                    else {
-                        // Sustain
-                        env = S;
-                    }
-                }
-                else {
-                    // NOTE IS RELEASED: compute level at release moment, then decay
-                    // If tOffF <= tOnF, or not meaningful, env=0 (no valid note)
-                    const double holdDurSec = (tOffF - tOnF) / sr;
-                    if (holdDurSec <= 0.0 || curFrame < tOffF) {
-                        // No valid release, or we're before the off time
-                        env = 0.0;
-                    }
-                    else {
-                        // Level at the exact release moment:
-                        double levelAtRelease = 0.0;
-                        if (holdDurSec < A) {
-                            levelAtRelease = linUp(holdDurSec, A); // still in attack when released
-                        }
-                        else if (holdDurSec < A + D) {
-                            levelAtRelease = linDownTo(holdDurSec - A, D, S); // in decay when released
-                        }
-                        else {
-                            levelAtRelease = S; // at sustain when released
-                        }
-
-                        // Time since release:
-                        const double tRelSec = (curFrame - tOffF) / sr;
-                        if (tRelSec <= 0.0) {
-                            env = levelAtRelease;
-                        }
-                        else {
-                            env = releaseFrom(tRelSec, R, levelAtRelease);
-                        }
-                    }
-                }
-
-                out[n] = std::clamp(env, 0.0, 1.0);
-            }
+            envelopeLanes(userInput, in, out, nullptr, 128);
+        };
+    envelopeType.executeActiveLanes = [](const NodeData&, UserInput& userInput, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&)
+        {
+            envelopeLanes(userInput, in, out, userInput.activeLanes, userInput.numActiveLanes);
+        };
+    envelopeType.laneRelease = [](const NodeData& nd, const RunnerInput& r) -> double
+        {
+            const NodeData* release = nd.getInput(3);
+            if (!release) return std::max(0.0, nd.defaultValues[3].d);
+            auto it = r.nodeCompileTimeOutputs.find(const_cast<NodeData*>(release));
+            if (it == r.nodeCompileTimeOutputs.end() || it->second.empty()) return RunnerInput::unknownLaneRelease;
+            return std::max(0.0, it->second[0].d);
         };
 
     registry.push_back(envelopeType);
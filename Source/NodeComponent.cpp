@@ -450,7 +450,8 @@ void NodeComponent::mouseUp(const juce::MouseEvent& e)
     draggingConnection = false;
     hoveredInputIndex = -1;
 
-    if (getType().isInputNode) {
+    // moving a node is cosmetic, unless it reorders the scene's inputs
+    if (getType().isInputNode && getOwningScene()->inputOrderChanged()) {
         getOwningScene()->editNodeType();
         owningScene.onSceneChanged();
     }
@@ -14,6 +14,7 @@
 #include "SceneComponent.h"
 #include "PluginEditor.h"
 #include <unordered_set>
+#include <algorithm>
 // Attach only if index valid & no loop
 
 
@@ -23,18 +24,17 @@
 
 NodeData::NodeData(const NodeType& type) : type(type), compileTimeSizes()
 {
-    if (type.fromScene) {
-		optionalRunnerInput = std::make_unique<RunnerInput>();
-    }
     defaultValues.resize(type.inputs.size());
     for (int i = 0; i < type.inputs.size(); i += 1) {
         defaultValues[i] = type.inputs[i].defaultValue;
     }
+    slots.assign(type.propertySlots.size(), 0.0); // what getNumericProperty says for a missing key
 }
 
 NodeData::NodeData(const NodeData& other) : NodeData(other.type) {
 	properties = other.properties;
 	numericProperties = other.numericProperties;
+	slots = other.slots;
 	position = other.position;
 	inputNodes = other.inputNodes;
 	outputs = other.outputs;
@@ -45,6 +45,7 @@ NodeData::NodeData(const NodeData& other) : NodeData(other.type) {
     optionalStoredAudio = other.optionalStoredAudio;
     defaultValues = other.defaultValues;
 	isCopy = true;
+	original = other.isCopy ? other.original : &other;
 }
 
 
@@ -65,7 +66,8 @@ const std::string NodeData::getStringProperty(const std::string& key) const noex
 }
 const double NodeData::getNumericProperty(const std::string& key) const noexcept
 {
-	return numericProperties.contains(key) ? numericProperties.at(key) : 0.0;
+	auto it = numericProperties.find(key);
+	return it != numericProperties.end() ? it->second : 0.0;
 }
 const std::vector<ddtype> NodeData::getCompileTimeValue(RunnerInput* inlineInstance, UserInput& fakeInput) const noexcept
 {
@@ -203,6 +205,10 @@ return dfsNCTI(this, visiting, memo);
 
 void NodeData::setProperty(const std::string& key, const double value) {
 numericProperties[key] = value;
+auto slot = std::find(type.propertySlots.begin(), type.propertySlots.end(), key);
+if (slot != type.propertySlots.end()) {
+    slots[slot - type.propertySlots.begin()] = value;
+}
 }
 
 juce::Point<int> NodeData::getPosition() const noexcept { return position; }
@@ -342,7 +348,7 @@ bool NodeData::attachInput(size_t idx, NodeData* other, RunnerInput& r, SceneDat
     //}
 
     if (ref && updateScene) {
-        ref->onSceneChanged();
+        ref->onSceneChanged(this);
     }
     
     return true;
@@ -359,7 +365,7 @@ void NodeData::detachInput(size_t idx, SceneData* referenceScene, bool updateSce
         }
         inputNodes[idx] = nullptr;
 		auto ref = dynamic_cast<SceneComponent*>(referenceScene);
-        if (ref && updateScene) { ref->onSceneChanged(); }
+        if (ref && updateScene) { ref->onSceneChanged(this); }
     }
 }
 
@@ -367,6 +373,11 @@ void NodeData::detachInput(size_t idx, SceneData* referenceScene, bool updateSce
 
 
 
+bool NodeData::isLive() const noexcept
+{
+    return getType()->liveValues != NodeType::LiveValues::none && (original ? original : this)->editedLive;
+}
+
 const bool NodeData::isCompileTimeKnown() const noexcept
 {
 // Node explicitly marked as runtime
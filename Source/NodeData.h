@@ -36,6 +36,8 @@ public:
     void setProperty(const std::string& key, const std::string& value);
     bool needsCompileTimeInputs() const;
     void setProperty(const std::string& key, const double value);
+    // the value of NodeType::propertySlots[slot], kept in step with setProperty
+    double getSlot(int slot) const noexcept { return slots[slot]; }
 
     juce::Point<int> getPosition() const noexcept;
     void setPosition(juce::Point<int> newPos) noexcept;
@@ -44,7 +46,10 @@ public:
 
     NodeData* getInput(size_t idx);
 
-    std::unique_ptr<RunnerInput> optionalRunnerInput = nullptr;
+    // custom nodes: the compiled sub-scene, shared with every other instance fed the same shapes and
+    // only read. set by the size query, see SceneData::compiledFor. what runs is the plan's own instance
+    // of it, RunnerInput::subRunners
+    mutable std::shared_ptr<RunnerInput> optionalRunnerInput = nullptr;
 
     // Attach only if index valid & no loop
     bool attachInput(size_t idx, NodeData* other, class RunnerInput& inlineInstance, class SceneData* referenceScene, bool updateScene = true);
@@ -52,6 +57,9 @@ public:
     void detachInput(size_t idx, SceneData* referenceScene, bool updateScene = true);
 
 	const bool isCompileTimeKnown() const noexcept;
+    // a live node (NodeType::liveValues) folds like any other constant until its first edit from the
+    // UI, which recompiles it as live. later edits go through pushLiveValues without a recompile
+    bool isLive() const noexcept;
 
     const int getNumInputs() const noexcept;
 
@@ -71,11 +79,14 @@ public:
 	void setTrueType(InputType t);
     int inputIndex = -1;
     bool isCopy = false;
+    const NodeData* original = nullptr; // copies only, the scene's node it was copied from
+    bool editedLive = false; // the scene's node only, see isLive
 private:
     InputType trueType;
     
     std::map<std::string, std::string> properties;
 	std::map<std::string, double> numericProperties;
+    std::vector<double> slots;
     juce::Point<int> position;
     const NodeType& type;
    
@@ -125,7 +125,7 @@ void NodePropertiesComponent::rebuildEditors()
                     editor->setText(juce::String(node.defaultValues[i].d), false);
                 }
 
-                attachedNode->getOwningScene()->onSceneChanged();
+                attachedNode->getOwningScene()->onSceneChanged(&attachedNode->getNodeData());
                 };
         }
         else if (type == InputType::integer)
@@ -138,7 +138,7 @@ void NodePropertiesComponent::rebuildEditors()
             editor->onTextChange = [this, editor, i]() {
                 if (attachedNode)
                     attachedNode->getNodeData().defaultValues[i].i = editor->getText().getIntValue();
-                    attachedNode->getOwningScene()->onSceneChanged();
+                    attachedNode->getOwningScene()->onSceneChanged(&attachedNode->getNodeData());
                 };
         }
         else if (type == InputType::boolean)
@@ -152,7 +152,7 @@ void NodePropertiesComponent::rebuildEditors()
             toggle->onClick = [this, toggle, i]() {
                 if (attachedNode)
                     attachedNode->getNodeData().defaultValues[i].i = toggle->getToggleState() ? 1 : 0;
-                    attachedNode->getOwningScene()->onSceneChanged();
+                    attachedNode->getOwningScene()->onSceneChanged(&attachedNode->getNodeData());
                 };
         }
 
@@ -26,7 +26,7 @@ void operateNodeDataChange(const NodeType& t, NodeComponent& n) {
     if (t._nodeDataChanged(n))
     {
         if (auto scene = n.getOwningScene()) {
-            scene->onSceneChanged();
+            scene->onSceneChanged(&n.getNodeData());
         }
     }
 }
@@ -60,7 +60,7 @@ void NodeType::nodeDataChanged(NodeComponent& n) const { //call from UI changes
                                 if (weakComp != nullptr && weakComp->currentVersion() == jobVersion)
                                 {
                                     if (auto* scene = weakComp->getOwningScene())
-                                        scene->onSceneChanged();
+                                        scene->onSceneChanged(&weakComp->getNodeData());
                                 }
                             });
                     }
@@ -5,6 +5,8 @@
 #include <vector>
 #include <span>
 #include <limits>
+#include <cmath>
+#include <cstdio>
 #include "NodeData.h"
 #include "InputType.h"
 #include "ddtype.h"
@@ -35,13 +37,50 @@ struct GlobalClangVar {
     std::string varName;
 };
 
+// Sanitizer for numeric values (ensures finite literal, not NaN/inf)
+inline std::string emitNumericLiteral(double d) {
+    if (!std::isfinite(d)) {
+        return "0.0"; // fallback
+    }
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.17g", d); // precise, portable C99 literal
+    std::string out = buf;
+    if (out.find_first_of(".eE") == std::string::npos) out += ".0"; // keep it a double in C
+    return out;
+}
+
+// Sanitizer for string values (UI ensures, but double safety here)
+inline std::string sanitizeIdentifier(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        if ((c >= 'a' && c <= 'z') ||
+            (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') ||
+            c == '_') {
+            out.push_back(c);
+        }
+    }
+    if (out.empty() || (out[0] >= '0' && out[0] <= '9')) {
+        out = "_" + out; // must be valid identifier
+    }
+    return out;
+}
+
 struct NodeType {
     juce::String name;
     juce::String address;
     juce::String tooltip;
     std::vector<InputFeatures> inputs;
+    // called on the audio thread for runtime nodes: no allocation, locking or I/O in here
     using ExecuteFn = void(*)(const NodeData& node, UserInput& userInput, const std::vector<std::span<ddtype>>& inputs, std::span<ddtype> output, const class RunnerInput& inlineInstance);
     ExecuteFn execute;
+    // numeric properties execute reads, in slot order. NodeData mirrors them into a plain vector, so
+    // execute indexes NodeData::getSlot instead of searching the property map by name
+    std::vector<std::string> propertySlots;
+    // picks a kernel for the node's settings (op_mode and the like) when Runner builds the plan, so the
+    // kernel never branches on them per call. null, or returning null, keeps execute
+    std::function<ExecuteFn(const NodeData&)> specialize;
     std::function<void(class NodeComponent&, NodeData&)> buildUI;
     std::function<int(const std::vector<NodeData*>& inputNodes, const std::vector<std::vector<ddtype>>& inputs, const class RunnerInput& inlineInstance, int inputNum, const NodeData& self)> getOutputSize;
     std::function<void(NodeComponent&)> onResized = [](NodeComponent&) {};
@@ -50,6 +89,40 @@ struct NodeType {
     void nodeDataChanged(NodeComponent& n) const; // call this function whenever UI changes the node's internal state. such as web audio got downloaded and cached in the node
     InputType outputType = InputType::decimal;
     bool alwaysOutputsRuntimeData = false;
+    /* runtime output that only moves with host/MIDI state (never mid sub-block), so the runner evaluates it once per sub-block instead of every sample */
+    bool isBlockRate = false;
+    // reads isStereoRight (directly or through the per-channel histories), so it runs once per output channel
+    bool dependsOnChannel = false;
+    // fresh random output on every call, two copies with the same inputs are still different nodes
+    bool isNondeterministic = false;
+    // values the UI can change while the plan plays, without a recompile (see Runner::setLiveValue), once
+    // the node has been edited (NodeData::isLive).
+    // output: the output is the value, the node is evaluated once and left out of the plan.
+    // table: optionalStoredAudio is copied into field and handed to execute as an extra last input
+    enum class LiveValues { none, output, table };
+    LiveValues liveValues = LiveValues::none;
+    // the 128-wide note vectors (note on, velocity, wave cycle, ...) only matter on the notes that sound,
+    // see UserInput::activeLanes and PlanStep::lanes. laneWise: lane k of the output only depends on lane
+    // k of each input. laneSum: the output is the sum of what the node gives for each lane on its own
+    bool laneWise = false;
+    bool laneSum = false;
+    // a source of note vectors writing the active lanes only, the runner switches to them when nothing
+    // downstream reads the other lanes
+    ExecuteFn executeActiveLanes = nullptr;
+    std::function<std::string(NodeData&, int uniqueNodeOrder)> emitActiveLanes;
+    // seconds a note's lane still moves after its note off, from the node's inputs (see
+    // RunnerInput::laneReleaseSeconds). null for nodes that go quiet at the note off
+    std::function<double(const NodeData&, const class RunnerInput&)> laneRelease;
+    // ddtypes the node keeps from one run to the next, zeroed at initialize. the runner puts them in
+    // field (so voices and runner swaps start over cleanly) and hands them in as an extra input after
+    // the table, see PlanStep::stateInput. emitCode sees them as st
+    int stateSize = 0;
+    // InputRead flags: the parts of UserInput execute and emitCode read that the processor only
+    // maintains on demand. the runner narrows readsNoteCycles down when the step runs on the active lanes
+    uint32_t inputReads = 0;
+    // frames back the node can read the output histories (readsHistories), from what the plan knows of
+    // its inputs. sizes RunnerInput::historyLength
+    std::function<int(const NodeData&, const class RunnerInput&)> historyLength;
     class SceneData* fromScene = nullptr;
     bool isInputNode = false;
     uint64_t NodeID;
@@ -10,6 +10,10 @@
 
 #pragma once
 #include <stdint.h>
+#include "StringifyDefines.h"
+
+// declared to JIT kernels as well, Runner binds the symbols to these definitions
+DEFINE_AND_CREATE_VAR(
 double uniform_closed(double a, double b);
 
 double deterministic_uniform_closed(double a, double b, double key);
@@ -23,3 +27,5 @@ double voronoiNoise(double x);
 double perlinNoise(double x, int64_t octaveCount, double lacunarity, double roughness);
 
 double ridgedMultiNoise(double x, int64_t octaveCount, double lacunarity);
+, NoiseClang
+);
@@ -8,6 +8,9 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeCheck.h"
+#include <exception>
+#include <latch>
 
 WaviateFlow2025AudioProcessor* activeInstance;
 
@@ -23,13 +26,14 @@ WaviateFlow2025AudioProcessor::WaviateFlow2025AudioProcessor() : dawManager(*thi
 {
     userInput = std::make_unique<UserInput>();
     dummyInput = std::make_unique<UserInput>();
+    frontInput = std::make_unique<UserInput>();
     userInput->numFramesStartOfBlock = 0;
     for (int i = 0; i < noteHzOfficialValues.size(); i += 1) {
         userInput->noteHz[i] = noteHzOfficialValues[i] = 440.0 * std::pow(2.0, (i - 69) / 12.0);
         userInput->noteVelocity[i] = 0.0;
         userInput->notesOn[i] = 0.0;
         userInput->noteStartFrame[i] = -100000000;
-        userInput->noteEndFrame[i] = 0.0;
+        userInput->noteEndFrame[i] = -100000000;
     }
     userInput->leftInputHistoryHead = userInput->rightInputHistoryHead = 0;
     userInput->leftInputHistorySize = userInput->rightInputHistorySize = 0;
@@ -43,11 +47,14 @@ WaviateFlow2025AudioProcessor::WaviateFlow2025AudioProcessor() : dawManager(*thi
         audibleScene = scenes[0].get();
         setActiveScene(dynamic_cast<SceneComponent*>(audibleScene));
     }
+    compiler.onCompiled = [this](RunnerInput* runner, NodeFn kernel) { installKernel(runner, kernel); };
     activeInstance = this;
 }
 
 WaviateFlow2025AudioProcessor::~WaviateFlow2025AudioProcessor()
 {
+    compiler.stop();
+    ownedRunners.clear(); // the audio thread is gone by now
     scenes.clear();
 }
 
@@ -118,13 +125,24 @@ void WaviateFlow2025AudioProcessor::prepareToPlay (double sampleRate, int sample
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    dbuff = juce::AudioBuffer<double>(getTotalNumOutputChannels(), samplesPerBlock);
+    // every bus channel incl. sidechain, so the float path never resizes on the audio thread
+    dbuff = juce::AudioBuffer<double>(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()), samplesPerBlock);
+    // half the cores at most, the host runs other plugins' callbacks alongside ours
+    branchPool.start(juce::jlimit(0, maxBranchWorkers, juce::SystemStats::getNumCpus() / 2 - 1));
+
+    // the pipeline's ring holds the block the back plays and the one the front renders
+    if (pipelineActive) stopPipeline();
+    pipelineLatency = samplesPerBlock;
+    pipelineFrames.assign((size_t)juce::nextPowerOfTwo(2 * samplesPerBlock), PipelineFrame{});
+    pipelineValues.assign(pipelineFrames.size() * 2 * RunnerInput::maxPipelineBoundary, ddtype(0.0));
+    setLatencySamples(isPipelined() && !isPolyphonic() ? pipelineLatency : 0);
 }
 
 void WaviateFlow2025AudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    branchPool.stop();
 }
 
 bool WaviateFlow2025AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -154,6 +172,7 @@ bool WaviateFlow2025AudioProcessor::isBusesLayoutSupported(const BusesLayout& la
 }
 
 void WaviateFlow2025AudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midi) {
+    REALTIME_AUDIO_SCOPE();
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -191,7 +210,7 @@ void WaviateFlow2025AudioProcessor::processBlock(juce::AudioBuffer<double>& buff
     const double* inSR = (numSInCh > 1) ? sidechainIn.getReadPointer(1)
         : (numSInCh > 0 ? sidechainIn.getReadPointer(0) : nullptr);
 
-    const double timePerSample = 1.0 / sampleRate;
+    updateNoteCycleSteps(sampleRate);
 
     if (numOutCh > 0) {
         double* outR, * outL;
@@ -200,77 +219,96 @@ void WaviateFlow2025AudioProcessor::processBlock(juce::AudioBuffer<double>& buff
             outR = mainOut.getWritePointer(1);
         }
 
-        const int64_t lastSwap = 0; //TODO fix!
-        const int64_t base = 50000; //TODO fix!
-        const RunnerInput* runner = nullptr;
-        const RunnerInput* prevRunner = nullptr;
+        const int fadeWindowSamples = std::max(1, int(fadeWindowSeconds * sampleRate));
 
-        runner = getCurrentRunner();
-        prevRunner = getPreviousRunner();
+        // before the pickup, a pipelined back may still be playing the runner about to be replaced
+        const bool pipelineWanted = pipelineRequested.load(std::memory_order_relaxed) && !isPolyphonic() && !pipelineFrames.empty();
+        if (pipelineWanted && !pipelineActive) startPipeline();
+        else if (!pipelineWanted && pipelineActive) stopPipeline();
 
-        const int fadeWindowSamples = int(fadeWindowSeconds * sampleRate);
+        // pick up a freshly published runner. a fade still in progress is cut short, the new one
+        // fades in from whatever was audible last
+        if (RunnerInput* next = pendingRunner.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (fadingRunner && !pipelineActive) {
+                retireRunner(fadingRunner);
+            }
+            fadingRunner = currentRunner;
+            currentRunner = next;
+            fadeSamplesDone = 0;
+            adoptVoices(next);
+            adoptHistories(next);
+        }
+        // after the pickup, so values pushed since the new runner was built land in it
+        applyLiveValues();
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            int64_t now = base + sample;
-            int64_t sinceSwap = now - lastSwap;
-            double alpha = (sinceSwap < fadeWindowSamples)
-                ? double(sinceSwap) / double(fadeWindowSamples)
-                : 1.0;
+        const double* inputs[4] = { inL, inR, inSL, inSR };
+        if (pipelineActive) {
+            processBlockPipelined(inputs, midi, buffer.getNumSamples(), outL, outR);
+            return;
+        }
 
-            userInput->leftInput = inL ? inL[sample] : 0.0f;
-            userInput->rightInput = inR ? inR[sample] : 0.0f;
-            userInput->sideChainL = inSL ? inSL[sample] : 0.0f;
-            userInput->sideChainR = inSR ? inSR[sample] : 0.0f;
+        const RunnerInput* runner = getCurrentRunner();
+        const RunnerInput* prevRunner = getPreviousRunner();
+        const int numSamples = buffer.getNumSamples();
 
+        int sample = 0;
+        while (sample < numSamples)
+        {
+            // Process all MIDI events scheduled up to the start of this sub-block
             userInput->sampleInBlock = sample;
-            // Process all MIDI events scheduled for this sample
-            while (hasEvent && eventSample == sample)
+            while (hasEvent && eventSample <= sample)
             {
                 handleMidi(msg, *userInput); // <-- your MIDI handling
+                handleVoiceMidi(msg, runner, prevRunner);
                 hasEvent = it.getNextEvent(msg, eventSample);
             }
+            updateActiveLanes(*userInput, runner, prevRunner);
+            const uint32_t reads = inputReads(runner, prevRunner);
 
-            for (int i = 0; i < 128; i += 1) {
-                userInput->noteCycle[i] = std::fmod(userInput->noteCycle[i] +
-                    noteHzOfficialValues[i] * timePerSample, 1.0);
+            // block-rate nodes only see host/MIDI state, so the sub-block ends at the next event
+            int subBlockEnd = std::min(numSamples, sample + maxSubBlockSamples);
+            if (hasEvent && eventSample < subBlockEnd) {
+                subBlockEnd = eventSample;
             }
 
-            outL[sample] = outR[sample] = userInput->isStereoRight = 0.0;
+            // a runner with voices plays through them alone, the whole sub-block at once
+            const int subBlockStart = sample;
             if (audibleScene) {
-
-                auto ndata = audibleScene->nodeDatas[0];
-                std::span<ddtype> l = Runner::run(runner, *userInput, std::vector<std::span<ddtype>>());
-                for (ddtype d : l) {
-                    outL[sample] += d.d * alpha;
+                if (!hasVoices(runner)) {
+                    Runner::runBlockRate(runner, *userInput);
                 }
-
-                userInput->isStereoRight = 1.0;
-                std::span<ddtype> r = Runner::run(runner, *userInput, std::vector<std::span<ddtype>>());
-                for (ddtype d : r) {
-                    outR[sample] += d.d * alpha;
+                if (prevRunner && !hasVoices(prevRunner)) {
+                    Runner::runBlockRate(prevRunner, *userInput);
                 }
+                renderVoices(runner, prevRunner, inputs, sample, subBlockEnd);
+            }
 
-                const double beta = 1 - alpha;
-                if (beta > 0.0) {
-                    userInput->isStereoRight = 0.0;
-                    std::span<ddtype> l = Runner::run(prevRunner, *userInput, std::vector<std::span<ddtype>>());
-                    for (ddtype d : l) {
-                        outL[sample] += d.d * beta;
-                    }
-
-                    userInput->isStereoRight = 1.0;
-                    std::span<ddtype> r = Runner::run(prevRunner, *userInput, std::vector<std::span<ddtype>>());
-                    for (ddtype d : r) {
-                        outR[sample] += d.d * beta;
+            for (; sample < subBlockEnd; ++sample)
+            {
+                double alpha = prevRunner ? double(fadeSamplesDone) / double(fadeWindowSamples) : 1.0;
+
+                const double samples[4] = {
+                    inL ? inL[sample] : 0.0, inR ? inR[sample] : 0.0,
+                    inSL ? inSL[sample] : 0.0, inSR ? inSR[sample] : 0.0 };
+                advanceLiveRamps(1);
+                advanceFrame(*userInput, samples, sample, reads);
+
+                outL[sample] = outR[sample] = 0.0;
+                if (audibleScene) {
+                    if (hasVoices(runner)) addVoicesOutput(0, sample - subBlockStart, alpha, outL[sample], outR[sample]);
+                    else addRunnerOutput(runner, *userInput, alpha, nullptr, outL[sample], outR[sample]);
+                    if (prevRunner) {
+                        if (hasVoices(prevRunner)) addVoicesOutput(1, sample - subBlockStart, 1 - alpha, outL[sample], outR[sample]);
+                        else addRunnerOutput(prevRunner, *userInput, 1 - alpha, nullptr, outL[sample], outR[sample]);
                     }
+                    finishFrame(outL[sample], outR[sample], reads);
                 }
-                CircleBuffer_add(userInput->rightInputHistoryArray, &userInput->rightInputHistoryHead, &userInput->rightInputHistorySize, outR[sample] = 10.0 * std::tanh(outR[sample] * 0.1));
-                CircleBuffer_add(userInput->leftInputHistoryArray, &userInput->leftInputHistoryHead, &userInput->leftInputHistorySize, outL[sample] = 10.0 * std::tanh(outL[sample] * 0.1));
-                float z = outL[sample];
-                auto sc = dynamic_cast<SceneComponent*>(audibleScene);
-                if (sc) {
-                    dynamic_cast<juce::AudioVisualiserComponent*>(sc->nodes[0]->inputGUIElements[0].get())->pushSample(&z, 1);
+
+                // once the fade is over the old runner is never evaluated again
+                if (prevRunner && ++fadeSamplesDone >= fadeWindowSamples) {
+                    retireRunner(fadingRunner);
+                    fadingRunner = nullptr;
+                    prevRunner = nullptr;
                 }
             }
         }
@@ -288,7 +326,9 @@ void WaviateFlow2025AudioProcessor::processBlock(juce::AudioBuffer<double>& buff
 
 void WaviateFlow2025AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    
+    REALTIME_AUDIO_SCOPE();
+    // no-op unless the host breaks its prepareToPlay promise
+    dbuff.setSize(buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
     for (int i = 0; i < buffer.getNumChannels(); i += 1) {
         for (int j = 0; j < buffer.getNumSamples(); j += 1) {
             dbuff.setSample(i, j, (double)buffer.getSample(i, j));
@@ -335,12 +375,16 @@ void WaviateFlow2025AudioProcessor::setStateInformation (const void* data, int s
 
 void WaviateFlow2025AudioProcessor::handleMidi(const juce::MidiMessage& message, UserInput& input)
 {
+    // the sub-block starts at the event, sampleInBlock is already there
+    const double frame = (double)(input.numFramesStartOfBlock + input.sampleInBlock);
     if (message.isNoteOn()) {
 		input.notesOn[message.getNoteNumber()] = 1.0;
 		input.noteVelocity[message.getNoteNumber()] = message.getFloatVelocity();
+		input.noteStartFrame[message.getNoteNumber()] = frame;
     }
     else if (message.isNoteOff()) {
 		input.notesOn[message.getNoteNumber()] = 0.0;
+		input.noteEndFrame[message.getNoteNumber()] = frame;
     }
 	else if (message.isController()) {
 		input.controllerValues[message.getControllerNumber()] = message.getControllerValue() / 127.0;
@@ -350,6 +394,547 @@ void WaviateFlow2025AudioProcessor::handleMidi(const juce::MidiMessage& message,
     }
 }
 
+double WaviateFlow2025AudioProcessor::releaseTailFrames(const RunnerInput* runner, const RunnerInput* prevRunner, double sampleRate) noexcept
+{
+    double release = 0.0;
+    for (const RunnerInput* r : { runner, prevRunner }) {
+        if (r) release = std::max(release, r->laneReleaseSeconds);
+    }
+    return release * sampleRate + maxSubBlockSamples;
+}
+
+// held notes, and released ones for as long as the longest release of the runners playing
+// (RunnerInput::laneReleaseSeconds). checked once per sub-block, so a released note gets one more on top
+void WaviateFlow2025AudioProcessor::updateActiveLanes(UserInput& input, const RunnerInput* runner, const RunnerInput* prevRunner) noexcept
+{
+    const double tail = releaseTailFrames(runner, prevRunner, input.sampleRate);
+    const double now = (double)(input.numFramesStartOfBlock + input.sampleInBlock);
+    input.numActiveLanes = 0;
+    for (int n = 0; n < MIDI_NOTE_COUNT; ++n) {
+        if (input.notesOn[n] != 0.0 || now - input.noteEndFrame[n] < tail) {
+            input.activeLanes[input.numActiveLanes++] = n;
+        }
+    }
+}
+
+uint32_t WaviateFlow2025AudioProcessor::inputReads(const RunnerInput* runner, const RunnerInput* prevRunner) noexcept
+{
+    uint32_t reads = 0;
+    for (const RunnerInput* r : { runner, prevRunner }) {
+        if (r) reads |= r->inputReads;
+    }
+    return reads;
+}
+
+void WaviateFlow2025AudioProcessor::updateNoteCycleSteps(double sampleRate) noexcept
+{
+    if (sampleRate == noteCycleRate || sampleRate <= 0.0) return;
+    noteCycleRate = sampleRate;
+    for (int n = 0; n < MIDI_NOTE_COUNT; ++n) {
+        noteCycleSteps[n] = std::fmod(noteHzOfficialValues[n] / sampleRate, 1.0);
+    }
+}
+
+// audio thread, at pickup. the runner faded from keeps reading whatever is in there: a history that
+// moved starts over empty, so it never reads past what was recorded
+void WaviateFlow2025AudioProcessor::adoptHistories(const RunnerInput* runner) noexcept
+{
+    double* storage = runner && runner->histories ? runner->histories->data() : nullptr;
+    if (storage == userInput->leftInputHistoryArray) return;
+    const int capacity = storage ? (int)runner->histories->size() / 2 : 0;
+    userInput->leftInputHistoryArray = storage;
+    userInput->rightInputHistoryArray = storage ? storage + capacity : nullptr;
+    userInput->historyMask = capacity - 1;
+    CircleBuffer_init(&userInput->leftInputHistoryHead, &userInput->leftInputHistorySize);
+    CircleBuffer_init(&userInput->rightInputHistoryHead, &userInput->rightInputHistorySize);
+}
+
+// the per-frame part of UserInput: this frame's input samples, where it sits in the block and the note
+// phases. the phases only move where some runner reads them: every lane in one branchless pass, or the
+// active lanes alone, which leaves the others where they stopped (a note's phase runs while it sounds,
+// as in a voice)
+void WaviateFlow2025AudioProcessor::advanceFrame(UserInput& input, const double* samples, int sample, uint32_t reads) noexcept
+{
+    input.leftInput = samples[0];
+    input.rightInput = samples[1];
+    input.sideChainL = samples[2];
+    input.sideChainR = samples[3];
+
+    input.sampleInBlock = sample;
+
+    if (reads & readsNoteCycles) {
+        for (int n = 0; n < MIDI_NOTE_COUNT; ++n) {
+            const double cycle = input.noteCycle[n] + noteCycleSteps[n];
+            input.noteCycle[n] = cycle >= 1.0 ? cycle - 1.0 : cycle;
+        }
+    }
+    else if (reads & readsActiveNoteCycles) {
+        for (int a = 0; a < input.numActiveLanes; ++a) {
+            const int n = input.activeLanes[a];
+            const double cycle = input.noteCycle[n] + noteCycleSteps[n];
+            input.noteCycle[n] = cycle >= 1.0 ? cycle - 1.0 : cycle;
+        }
+    }
+}
+
+// boundary is what the pipeline front left for this runner, null when not pipelined
+void WaviateFlow2025AudioProcessor::addRunnerOutput(const RunnerInput* runner, UserInput& input, double gain, const ddtype* boundary, double& l, double& r) noexcept
+{
+    input.isStereoRight = 0.0;
+    // channel-invariant nodes run once per frame, only the per-channel tail runs twice
+    if (boundary) {
+        Runner::runSampleRateBack(runner, input, std::span<const ddtype>(boundary, RunnerInput::maxPipelineBoundary));
+    }
+    else {
+        Runner::runSampleRate(runner, input, &branchPool);
+    }
+    double left = 0.0;
+    for (ddtype d : Runner::runChannel(runner, input)) {
+        left += d.d;
+    }
+    double right = left;
+    if (runner && runner->dependsOnChannel) {
+        input.isStereoRight = 1.0;
+        right = 0.0;
+        for (ddtype d : Runner::runChannel(runner, input)) {
+            right += d.d;
+        }
+    }
+    l += left * gain;
+    r += right * gain;
+}
+
+// soft clip, the per-channel histories and the output node's scope. the histories are only recorded while
+// a runner reads them, and start over empty after a gap rather than with a hole in them
+void WaviateFlow2025AudioProcessor::finishFrame(double& l, double& r, uint32_t reads) noexcept
+{
+    r = 10.0 * std::tanh(r * 0.1);
+    l = 10.0 * std::tanh(l * 0.1);
+    if ((reads & readsHistories) && userInput->leftInputHistoryArray) {
+        if (!recordingHistories) {
+            CircleBuffer_init(&userInput->rightInputHistoryHead, &userInput->rightInputHistorySize);
+            CircleBuffer_init(&userInput->leftInputHistoryHead, &userInput->leftInputHistorySize);
+        }
+        CircleBuffer_add(userInput->rightInputHistoryArray, &userInput->rightInputHistoryHead, &userInput->rightInputHistorySize, userInput->historyMask, r);
+        CircleBuffer_add(userInput->leftInputHistoryArray, &userInput->leftInputHistoryHead, &userInput->leftInputHistorySize, userInput->historyMask, l);
+    }
+    recordingHistories = (reads & readsHistories) && userInput->leftInputHistoryArray;
+    float z = l;
+    auto sc = dynamic_cast<SceneComponent*>(audibleScene);
+    if (sc) {
+        dynamic_cast<juce::AudioVisualiserComponent*>(sc->nodes[0]->inputGUIElements[0].get())->pushSample(&z, 1);
+    }
+}
+
+void WaviateFlow2025AudioProcessor::setPipelined(bool shouldPipeline)
+{
+    if (pipelineRequested.exchange(shouldPipeline) == shouldPipeline) return;
+    setLatencySamples(shouldPipeline && !isPolyphonic() ? pipelineLatency : 0);
+    initializeRunner(); // split, or not, for the new mode
+}
+
+void WaviateFlow2025AudioProcessor::setPolyphonic(bool shouldBePolyphonic)
+{
+    if (polyphonyRequested.exchange(shouldBePolyphonic) == shouldBePolyphonic) return;
+    setLatencySamples(isPipelined() && !shouldBePolyphonic ? pipelineLatency : 0);
+    initializeRunner(); // with voices, or without
+}
+
+void WaviateFlow2025AudioProcessor::setVoiceLimit(int limit)
+{
+    limit = juce::jlimit(1, maxVoices, limit);
+    if (voiceLimit.exchange(limit) == limit) return;
+    if (isPolyphonic()) initializeRunner();
+}
+
+// everything a voice shares with userInput: controllers, host state and where the block is. its notes
+// are its own, and it has no history of what was played. the host's parameter tables only when read
+static void syncVoiceInput(UserInput& voice, const UserInput& from, uint32_t reads) noexcept
+{
+    std::copy(std::begin(from.controllerValues), std::end(from.controllerValues), std::begin(voice.controllerValues));
+    std::copy(std::begin(from.noteHz), std::end(from.noteHz), std::begin(voice.noteHz));
+    if (reads & readsHostValues) {
+        std::copy(std::begin(from.dawParams), std::end(from.dawParams), std::begin(voice.dawParams));
+        std::copy(std::begin(from.midiCCValues), std::end(from.midiCCValues), std::begin(voice.midiCCValues));
+    }
+    voice.pitchWheelValue = from.pitchWheelValue;
+    voice.modWheelValue = from.modWheelValue;
+    voice.numFramesStartOfBlock = from.numFramesStartOfBlock;
+    voice.sampleInBlock = from.sampleInBlock;
+    voice.sampleRate = from.sampleRate;
+    voice.isRealTime = from.isRealTime;
+    voice.isPlaying = from.isPlaying;
+    voice.isLooping = from.isLooping;
+    voice.isRecording = from.isRecording;
+    voice.isMetronomeGoing = from.isMetronomeGoing;
+    voice.timeSigTop = from.timeSigTop;
+    voice.timeSigBottom = from.timeSigBottom;
+    voice.BPM = from.BPM;
+}
+
+// a voice sees one note, its own, held from frame on and with its phase starting over
+static void startVoiceInput(UserInput& input, int note, double velocity, double frame) noexcept
+{
+    std::fill(std::begin(input.notesOn), std::end(input.notesOn), 0.0);
+    std::fill(std::begin(input.noteVelocity), std::end(input.noteVelocity), 0.0);
+    std::fill(std::begin(input.noteStartFrame), std::end(input.noteStartFrame), -100000000);
+    std::fill(std::begin(input.noteEndFrame), std::end(input.noteEndFrame), -100000000);
+    std::fill(std::begin(input.noteCycle), std::end(input.noteCycle), 0.0);
+    input.notesOn[note] = 1.0;
+    input.noteVelocity[note] = velocity;
+    input.noteStartFrame[note] = frame;
+    input.activeLanes[0] = note;
+    input.numActiveLanes = 1;
+}
+
+// audio thread. a note already playing gets its voice back, a new one takes a free voice or steals
+void WaviateFlow2025AudioProcessor::handleVoiceMidi(const juce::MidiMessage& message, const RunnerInput* runner, const RunnerInput* prevRunner) noexcept
+{
+    const int numVoices = std::max(hasVoices(runner) ? (int)runner->voices.size() : 0, hasVoices(prevRunner) ? (int)prevRunner->voices.size() : 0);
+    if (numVoices == 0) return;
+    const juce::int64 frame = userInput->numFramesStartOfBlock + userInput->sampleInBlock;
+    const RunnerInput* runners[2] = { runner, prevRunner };
+    if (message.isNoteOn()) {
+        const int note = message.getNoteNumber();
+        int v = -1;
+        for (int i = 0; i < numVoices && v < 0; ++i) {
+            if (voices[i].note == note) v = i;
+        }
+        for (int i = 0; i < numVoices && v < 0; ++i) {
+            if (voices[i].note < 0) v = i;
+        }
+        if (v < 0) {
+            // the note released longest ago, else the one held longest
+            v = 0;
+            for (int i = 1; i < numVoices; ++i) {
+                const Voice& a = voices[i];
+                const Voice& b = voices[v];
+                if (a.held != b.held ? !a.held : a.held ? a.started < b.started : a.released < b.released) v = i;
+            }
+        }
+        voices[v] = { note, true, (double)message.getFloatVelocity(), frame, 0 };
+        for (const RunnerInput* r : runners) {
+            if (!hasVoices(r) || v >= (int)r->voices.size()) continue;
+            Runner::resetVoice(r, v);
+            startVoiceInput(*r->voices[v].input, note, voices[v].velocity, (double)frame);
+        }
+    }
+    else if (message.isNoteOff()) {
+        const int note = message.getNoteNumber();
+        for (int v = 0; v < numVoices; ++v) {
+            if (voices[v].note != note || !voices[v].held) continue;
+            voices[v].held = false;
+            voices[v].released = frame;
+            for (const RunnerInput* r : runners) {
+                if (!hasVoices(r) || v >= (int)r->voices.size()) continue;
+                r->voices[v].input->notesOn[note] = 0.0;
+                r->voices[v].input->noteEndFrame[note] = (double)frame;
+            }
+        }
+    }
+}
+
+// audio thread. a runner picked up mid-note plays the voices on from a fresh state
+void WaviateFlow2025AudioProcessor::adoptVoices(const RunnerInput* runner) noexcept
+{
+    if (!hasVoices(runner)) return;
+    for (int v = 0; v < (int)runner->voices.size(); ++v) {
+        const Voice& voice = voices[v];
+        if (voice.note < 0) continue;
+        UserInput& input = *runner->voices[v].input;
+        startVoiceInput(input, voice.note, voice.velocity, (double)voice.started);
+        if (!voice.held) {
+            input.notesOn[voice.note] = 0.0;
+            input.noteEndFrame[voice.note] = (double)voice.released;
+        }
+    }
+}
+
+// audio thread. frees the voices whose release is over, then every other one renders [start, end) into
+// voiceOutput as a task of its own. the voices share nothing, see RunnerInput::voices
+void WaviateFlow2025AudioProcessor::renderVoices(const RunnerInput* runner, const RunnerInput* prevRunner, const double* const* inputs, int start, int end) noexcept
+{
+    numPlayingVoices = 0;
+    const int numVoices = std::max(hasVoices(runner) ? (int)runner->voices.size() : 0, hasVoices(prevRunner) ? (int)prevRunner->voices.size() : 0);
+    if (numVoices == 0) {
+        for (Voice& voice : voices) voice.note = -1; // nothing left to adopt them, see adoptVoices
+        return;
+    }
+    const double tail = releaseTailFrames(runner, prevRunner, userInput->sampleRate);
+    const double now = (double)(userInput->numFramesStartOfBlock + start);
+    for (int v = 0; v < maxVoices; ++v) {
+        Voice& voice = voices[v];
+        if (voice.note < 0) continue;
+        if (v >= numVoices || (!voice.held && now - (double)voice.released >= tail)) {
+            voice.note = -1;
+            continue;
+        }
+        playingVoices[numPlayingVoices++] = v;
+    }
+    VoiceJob job{ this, { runner, prevRunner }, inputs, start, end };
+    branchPool.run(&runVoiceTask, &job, numPlayingVoices);
+}
+
+void WaviateFlow2025AudioProcessor::runVoiceTask(void* context, int task)
+{
+    const VoiceJob& job = *static_cast<const VoiceJob*>(context);
+    job.processor->renderVoice(job.processor->playingVoices[task], job);
+}
+
+// one voice through both runners, on whichever thread of the pool claimed it. same frame order as
+// processBlock: block-rate steps once, then per sample the frame and each channel
+void WaviateFlow2025AudioProcessor::renderVoice(int v, const VoiceJob& job) noexcept
+{
+    const int note = voices[v].note;
+    for (int slot = 0; slot < 2; ++slot) {
+        const RunnerInput* runner = job.runners[slot];
+        double* out = voiceOutput[v].data() + slot * 2;
+        if (!hasVoices(runner) || v >= (int)runner->voices.size()) {
+            for (int i = 0; i < job.end - job.start; ++i) out[i * 4] = out[i * 4 + 1] = 0.0;
+            continue;
+        }
+        UserInput& input = *runner->voices[v].input;
+        syncVoiceInput(input, *userInput, runner->inputReads);
+        const bool cycles = (runner->inputReads & (readsNoteCycles | readsActiveNoteCycles)) != 0;
+        Runner::runVoice(runner, v, 0);
+        for (int sample = job.start; sample < job.end; ++sample) {
+            input.leftInput = job.inputs[0] ? job.inputs[0][sample] : 0.0;
+            input.rightInput = job.inputs[1] ? job.inputs[1][sample] : 0.0;
+            input.sideChainL = job.inputs[2] ? job.inputs[2][sample] : 0.0;
+            input.sideChainR = job.inputs[3] ? job.inputs[3][sample] : 0.0;
+            input.sampleInBlock = sample;
+            if (cycles) {
+                const double cycle = input.noteCycle[note] + noteCycleSteps[note];
+                input.noteCycle[note] = cycle >= 1.0 ? cycle - 1.0 : cycle;
+            }
+
+            input.isStereoRight = false;
+            Runner::runVoice(runner, v, 1);
+            double left = 0.0;
+            for (ddtype d : Runner::runVoice(runner, v, 2)) left += d.d;
+            double right = left;
+            if (runner->dependsOnChannel) {
+                input.isStereoRight = true;
+                right = 0.0;
+                for (ddtype d : Runner::runVoice(runner, v, 2)) right += d.d;
+            }
+            out[(sample - job.start) * 4] = left;
+            out[(sample - job.start) * 4 + 1] = right;
+        }
+    }
+}
+
+// the voices' sum for one sample of the sub-block, slot 0 for runner and 1 for prevRunner
+void WaviateFlow2025AudioProcessor::addVoicesOutput(int slot, int index, double gain, double& l, double& r) const noexcept
+{
+    for (int p = 0; p < numPlayingVoices; ++p) {
+        const double* out = voiceOutput[playingVoices[p]].data() + index * 4 + slot * 2;
+        l += out[0] * gain;
+        r += out[1] * gain;
+    }
+}
+
+WaviateFlow2025AudioProcessor::PipelineFrame& WaviateFlow2025AudioProcessor::pipelineFrameAt(juce::int64 frame) noexcept
+{
+    return pipelineFrames[(size_t)(frame & (juce::int64)(pipelineFrames.size() - 1))];
+}
+
+std::span<ddtype> WaviateFlow2025AudioProcessor::pipelineValuesAt(juce::int64 frame, int slot) noexcept
+{
+    const size_t index = (size_t)(frame & (juce::int64)(pipelineFrames.size() - 1));
+    return std::span<ddtype>(pipelineValues.data() + (index * 2 + slot) * RunnerInput::maxPipelineBoundary, RunnerInput::maxPipelineBoundary);
+}
+
+// audio thread. the back starts out a block of silence behind the front, both from the state userInput is in now
+void WaviateFlow2025AudioProcessor::startPipeline() noexcept
+{
+    pipelineActive = true;
+    pipelineFrame = pipelineStart = userInput->numFramesStartOfBlock;
+    pipelineEventsWritten = frontEventsRead = backEventsRead = 0;
+    backRunner = backPrevRunner = nullptr;
+    std::fill(pipelineFrames.begin(), pipelineFrames.end(), PipelineFrame{});
+    *frontInput = *userInput;
+    // the histories are read by channel steps only, never the front's, and userInput's may move
+    frontInput->leftInputHistoryArray = frontInput->rightInputHistoryArray = nullptr;
+    frontInput->leftInputHistorySize = frontInput->rightInputHistorySize = 0;
+}
+
+// audio thread, or prepareToPlay. drops the block the back still had to play: the MIDI in it still
+// counts, and every runner only the ring still knew about is retired
+void WaviateFlow2025AudioProcessor::stopPipeline() noexcept
+{
+    pipelineActive = false;
+    for (; backEventsRead < pipelineEventsWritten; ++backEventsRead) {
+        handleMidi(pipelineEvents[(size_t)(backEventsRead % maxPipelineEvents)].message, *userInput);
+    }
+    std::copy(std::begin(frontInput->noteCycle), std::end(frontInput->noteCycle), std::begin(userInput->noteCycle));
+    userInput->numFramesStartOfBlock = pipelineFrame;
+
+    std::array<RunnerInput*, maxRetiredRunners> retired{};
+    int numRetired = 0;
+    auto retire = [&](RunnerInput* runner) {
+        if (!runner || runner == currentRunner || runner == fadingRunner) return;
+        if (std::find(retired.begin(), retired.begin() + numRetired, runner) != retired.begin() + numRetired) return;
+        if (numRetired == (int)retired.size()) return;
+        retired[numRetired++] = runner;
+        retireRunner(runner);
+    };
+    retire(backRunner);
+    retire(backPrevRunner);
+    for (juce::int64 frame = std::max(pipelineStart, pipelineFrame - pipelineLatency); frame < pipelineFrame; ++frame) {
+        retire(pipelineFrameAt(frame).runner);
+        retire(pipelineFrameAt(frame).prevRunner);
+    }
+    backRunner = backPrevRunner = nullptr;
+}
+
+// the host's block in chunks of at most pipelineLatency: the front renders the chunk that just came in
+// while the back plays the one pipelineLatency samples earlier, whose front was rendered by then
+void WaviateFlow2025AudioProcessor::processBlockPipelined(const double* const* inputs, const juce::MidiBuffer& midi, int numSamples, double* outL, double* outR) noexcept
+{
+    REALTIME_SITE();
+    frontInput->sampleRate = userInput->sampleRate;
+    const int fadeWindowSamples = std::max(1, int(fadeWindowSeconds * userInput->sampleRate));
+    const juce::int64 blockStart = pipelineFrame;
+    const juce::int64 blockFirstEvent = pipelineEventsWritten;
+    for (const auto metadata : midi) {
+        // short messages only, they fit a MidiMessage without touching the heap. handleMidi has no use
+        // for anything longer (sysex) on the other path either
+        if (metadata.numBytes > 3) continue;
+        const juce::MidiMessage message = metadata.getMessage();
+        // a lost note-off leaves the note held, so the rest of the ring is kept for them
+        const bool noteOff = message.isNoteOff();
+        const int room = maxPipelineEvents - (noteOff ? 0 : pipelineNoteOffReserve);
+        if (pipelineEventsWritten - backEventsRead >= room) {
+            midiEventsDropped.fetch_add(1, std::memory_order_relaxed);
+            if (!noteOff || !makeRoomForNoteOff(blockFirstEvent)) continue;
+        }
+        pipelineEvents[(size_t)(pipelineEventsWritten % maxPipelineEvents)] = { blockStart + metadata.samplePosition, message };
+        ++pipelineEventsWritten;
+    }
+
+    for (int chunkStart = 0; chunkStart < numSamples; ) {
+        const int chunk = std::min(numSamples - chunkStart, pipelineLatency);
+        // the runners of every frame are settled here, the back follows them a block later
+        for (int i = 0; i < chunk; ++i) {
+            PipelineFrame& frame = pipelineFrameAt(pipelineFrame + i);
+            for (int c = 0; c < 4; ++c) {
+                frame.input[c] = inputs[c] ? inputs[c][chunkStart + i] : 0.0;
+            }
+            frame.runner = audibleScene ? currentRunner : nullptr;
+            frame.prevRunner = audibleScene ? fadingRunner : nullptr;
+            frame.alpha = fadingRunner ? double(fadeSamplesDone) / double(fadeWindowSamples) : 1.0;
+            if (fadingRunner && ++fadeSamplesDone >= fadeWindowSamples) {
+                fadingRunner = nullptr; // the back retires it once it's done with it
+            }
+        }
+
+        advanceLiveRamps(chunk); // a chunk at a time here, the stages render it side by side
+        PipelineJob job{ this, chunk, outL + chunkStart, outR + chunkStart };
+        branchPool.run(&runPipelineStage, &job, 2);
+        pipelineFrame += chunk;
+        chunkStart += chunk;
+    }
+}
+
+// audio thread, the ring is full. drops the latest event of this block that isn't a note-off, none of
+// which either stage has read yet, and closes the gap. false when there is none
+bool WaviateFlow2025AudioProcessor::makeRoomForNoteOff(juce::int64 blockFirstEvent) noexcept
+{
+    for (juce::int64 victim = pipelineEventsWritten - 1; victim >= blockFirstEvent; --victim) {
+        if (pipelineEvents[(size_t)(victim % maxPipelineEvents)].message.isNoteOff()) continue;
+        for (juce::int64 i = victim; i + 1 < pipelineEventsWritten; ++i) {
+            pipelineEvents[(size_t)(i % maxPipelineEvents)] = pipelineEvents[(size_t)((i + 1) % maxPipelineEvents)];
+        }
+        --pipelineEventsWritten;
+        return true;
+    }
+    return false;
+}
+
+// task 0 is the back, the audible one: the audio thread claims it first
+void WaviateFlow2025AudioProcessor::runPipelineStage(void* context, int task)
+{
+    const PipelineJob& job = *static_cast<const PipelineJob*>(context);
+    job.processor->renderPipelineStage(task == 1, job.numSamples, job.outL, job.outR);
+}
+
+void WaviateFlow2025AudioProcessor::renderPipelineStage(bool front, int numSamples, double* outL, double* outR) noexcept
+{
+    const juce::int64 first = front ? pipelineFrame : pipelineFrame - pipelineLatency;
+    UserInput& input = front ? *frontInput : *userInput;
+    juce::int64& eventsRead = front ? frontEventsRead : backEventsRead;
+    input.numFramesStartOfBlock = first;
+
+    int sample = 0;
+    while (sample < numSamples) {
+        input.sampleInBlock = sample;
+        while (eventsRead < pipelineEventsWritten && pipelineEvents[(size_t)(eventsRead % maxPipelineEvents)].frame <= first + sample) {
+            handleMidi(pipelineEvents[(size_t)(eventsRead % maxPipelineEvents)].message, input);
+            ++eventsRead;
+        }
+        // same sub-blocks as processBlock, and a runner picked up mid-way through starts one of its own
+        int subBlockEnd = std::min(numSamples, sample + maxSubBlockSamples);
+        if (eventsRead < pipelineEventsWritten) {
+            const juce::int64 next = pipelineEvents[(size_t)(eventsRead % maxPipelineEvents)].frame - first;
+            subBlockEnd = (int)std::min<juce::int64>(subBlockEnd, next);
+        }
+        const PipelineFrame& head = pipelineFrameAt(first + sample);
+        for (int k = sample + 1; k < subBlockEnd; ++k) {
+            if (pipelineFrameAt(first + k).runner != head.runner) {
+                subBlockEnd = k;
+                break;
+            }
+        }
+
+        updateActiveLanes(input, head.runner, head.prevRunner);
+        const uint32_t reads = inputReads(head.runner, head.prevRunner);
+        if (first + sample >= pipelineStart) {
+            if (front) {
+                Runner::runBlockRateFront(head.runner, input);
+                Runner::runBlockRateFront(head.prevRunner, input);
+            }
+            else {
+                Runner::runBlockRate(head.runner, input);
+                Runner::runBlockRate(head.prevRunner, input);
+            }
+        }
+
+        for (; sample < subBlockEnd; ++sample) {
+            const juce::int64 frameIndex = first + sample;
+            if (frameIndex < pipelineStart) {
+                if (!front) outL[sample] = outR[sample] = 0.0;
+                continue;
+            }
+            const PipelineFrame& frame = pipelineFrameAt(frameIndex);
+            advanceFrame(input, frame.input, sample, reads);
+            std::span<ddtype> values = pipelineValuesAt(frameIndex, 0);
+            std::span<ddtype> prevValues = pipelineValuesAt(frameIndex, 1);
+            if (front) {
+                Runner::runSampleRateFront(frame.runner, input, values);
+                Runner::runSampleRateFront(frame.prevRunner, input, prevValues);
+                continue;
+            }
+
+            // a runner no frame refers to anymore is done for
+            for (RunnerInput* old : { backRunner, backPrevRunner }) {
+                if (old && old != frame.runner && old != frame.prevRunner) retireRunner(old);
+            }
+            backRunner = frame.runner;
+            backPrevRunner = frame.prevRunner;
+
+            outL[sample] = outR[sample] = 0.0;
+            if (frame.runner) {
+                addRunnerOutput(frame.runner, input, frame.alpha, values.data(), outL[sample], outR[sample]);
+                if (frame.prevRunner) {
+                    addRunnerOutput(frame.prevRunner, input, 1 - frame.alpha, prevValues.data(), outL[sample], outR[sample]);
+                }
+                finishFrame(outL[sample], outR[sample], reads);
+            }
+        }
+    }
+}
+
 void WaviateFlow2025AudioProcessor::initializeRunner()
 {
     if (scenes.empty()) return;
@@ -473,22 +1058,174 @@ WaviateFlow2025AudioProcessor* WaviateFlow2025AudioProcessor::GetActiveInstance(
     return activeInstance;
 }
 
+// audio thread only
 const RunnerInput* WaviateFlow2025AudioProcessor::getCurrentRunner() const noexcept {
-    return &runners[(runnerIndex.load(std::memory_order::acquire) + 0) % nBufferSize];
+    return currentRunner;
 }
 
+// audio thread only, null once the crossfade has finished
 const RunnerInput* WaviateFlow2025AudioProcessor::getPreviousRunner() const noexcept
 {
-    return &runners[(runnerIndex.load(std::memory_order::acquire) + 1) % nBufferSize];
+    return fadingRunner;
 }
 
+void WaviateFlow2025AudioProcessor::retireRunner(RunnerInput* runner) noexcept
+{
+    if (!runner) return;
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToWrite(1, start1, size1, start2, size2);
+    jassert(size1 + size2 == 1); // message thread hasn't reclaimed in ages, the runner leaks
+    if (size1 > 0) retiredRunners[start1] = runner;
+    else if (size2 > 0) retiredRunners[start2] = runner;
+    retiredFifo.finishedWrite(size1 + size2);
+}
+
+void WaviateFlow2025AudioProcessor::reclaimRetiredRunners()
+{
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToRead(retiredFifo.getNumReady(), start1, size1, start2, size2);
+    auto reclaim = [this](RunnerInput* runner) {
+        std::erase_if(ownedRunners, [runner](const std::unique_ptr<RunnerInput>& r) { return r.get() == runner; });
+    };
+    for (int i = 0; i < size1; ++i) reclaim(retiredRunners[start1 + i]);
+    for (int i = 0; i < size2; ++i) reclaim(retiredRunners[start2 + i]);
+    retiredFifo.finishedRead(size1 + size2);
+}
 
 void WaviateFlow2025AudioProcessor::swapToNextRunner()
 {
-    int i = runnerIndex.load(std::memory_order::acquire);
-    auto& nextRunner = runners[(i + 1) % nBufferSize];
-    Runner::initialize(nextRunner, audibleScene, std::vector<std::span<ddtype>>());
-    runnerIndex.store((i + 1) % nBufferSize, std::memory_order_release);
+    reclaimRetiredRunners();
+
+    auto next = std::make_unique<RunnerInput>();
+    next->pipelined = isPipelined() && !isPolyphonic();
+    next->numVoices = isPolyphonic() ? getVoiceLimit() : 0;
+    Runner::initialize(*next, audibleScene, std::vector<std::span<ddtype>>());
+    // storage for the histories the plan reads, the last runner's when it's the same size
+    if (next->historyLength > 0) {
+        const size_t capacity = (size_t)juce::nextPowerOfTwo(next->historyLength);
+        if (!historyStorage || historyStorage->size() != 2 * capacity) {
+            historyStorage = std::make_shared<std::vector<double>>(2 * capacity, 0.0);
+        }
+        next->histories = historyStorage;
+    }
+    else historyStorage.reset(); // whatever runner still plays it keeps it until it's reclaimed
+
+    // warm up: one dry-run sub-block on a scratch UserInput so every page of the field and every
+    // lazily built table is touched here instead of on the first audio callback. the field is put
+    // back afterwards so stateful nodes start from the same place they would have
+    if (!next->nodeCopies.empty()) {
+        auto warmupInput = std::make_unique<UserInput>();
+        warmupInput->sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+        std::vector<ddtype> initialField(next->field.begin(), next->field.end());
+        std::vector<ddtype> initialPipelineField(next->pipelineField.begin(), next->pipelineField.end());
+        std::vector<ddtype> boundary(RunnerInput::maxPipelineBoundary);
+        // every lane, so the steps on the active lanes touch all of theirs as well
+        for (int n = 0; n < MIDI_NOTE_COUNT; ++n) warmupInput->activeLanes[n] = n;
+        warmupInput->numActiveLanes = MIDI_NOTE_COUNT;
+        Runner::runBlockRate(next.get(), *warmupInput);
+        Runner::runBlockRateFront(next.get(), *warmupInput);
+        for (int i = 0; i < maxSubBlockSamples; ++i) {
+            warmupInput->isStereoRight = false;
+            Runner::runSampleRateFront(next.get(), *warmupInput, boundary);
+            Runner::runSampleRate(next.get(), *warmupInput);
+            Runner::runChannel(next.get(), *warmupInput);
+            warmupInput->isStereoRight = true;
+            Runner::runChannel(next.get(), *warmupInput);
+        }
+        std::copy(initialField.begin(), initialField.end(), next->field.begin());
+        std::copy(initialPipelineField.begin(), initialPipelineField.end(), next->pipelineField.begin());
+        // custom nodes that weren't inlined start over on fresh instances
+        for (auto& [node, sub] : next->subRunners) {
+            if (sub->instanceOf) sub = Runner::instantiate(sub->instanceOf);
+        }
+        // the voices too, each on its own field, then back to voiceField
+        for (int v = 0; v < (int)next->voices.size(); ++v) {
+            UserInput& input = *next->voices[v].input;
+            input.sampleRate = warmupInput->sampleRate;
+            for (int n = 0; n < MIDI_NOTE_COUNT; ++n) input.activeLanes[n] = n;
+            input.numActiveLanes = MIDI_NOTE_COUNT;
+            Runner::runVoice(next.get(), v, 0);
+            for (int i = 0; i < maxSubBlockSamples; ++i) {
+                Runner::runVoice(next.get(), v, 1);
+                Runner::runVoice(next.get(), v, 2);
+            }
+            input.numActiveLanes = 0;
+            Runner::resetVoice(next.get(), v);
+        }
+    }
+
+    RunnerInput* published = next.get();
+    ownedRunners.push_back(std::move(next));
+    // a runner the audio thread never picked up was never seen by it, so it can go right away
+    if (RunnerInput* skipped = pendingRunner.exchange(published, std::memory_order_acq_rel)) {
+        std::erase_if(ownedRunners, [skipped](const std::unique_ptr<RunnerInput>& r) { return r.get() == skipped; });
+    }
+#if WAVIATE_JIT
+    compiler.submit(*published);
+#endif
+}
+
+bool WaviateFlow2025AudioProcessor::pushLiveValues(const NodeData* node, std::span<const ddtype> values)
+{
+    if (ownedRunners.empty() || values.empty()) return false;
+    // the newest is always last. resized, the field layout has to change
+    if (!Runner::hasLiveSlots(*ownedRunners.back(), node, (int)values.size())) return false;
+    if (liveFifo.getFreeSpace() < (int)values.size()) return false;
+
+    // the audio thread never looks at the node itself, it may be gone by the time the values land
+    const bool glides = node->getType()->liveValues == NodeType::LiveValues::output && node->getType()->outputType == InputType::decimal;
+    int start1, size1, start2, size2;
+    liveFifo.prepareToWrite((int)values.size(), start1, size1, start2, size2);
+    for (int i = 0; i < size1; ++i) liveValues[start1 + i] = { node, i, values[i], glides };
+    for (int i = 0; i < size2; ++i) liveValues[start2 + i] = { node, size1 + i, values[size1 + i], glides };
+    liveFifo.finishedWrite(size1 + size2);
+    return true;
+}
+
+void WaviateFlow2025AudioProcessor::applyLiveValues() noexcept
+{
+    const int rampLength = int(liveSmoothingSeconds.load(std::memory_order_relaxed) * userInput->sampleRate);
+    int start1, size1, start2, size2;
+    liveFifo.prepareToRead(liveFifo.getNumReady(), start1, size1, start2, size2);
+    auto apply = [this, rampLength](const LiveValue& v) {
+        // a ramp under way for the value is taken over from wherever it got to
+        ddtype from;
+        if (v.glides && rampLength > 0 && Runner::getLiveValue(currentRunner, v.node, v.index, from)) {
+            int r = 0;
+            while (r < numLiveRamps && (liveRamps[r].node != v.node || liveRamps[r].index != v.index)) ++r;
+            if (r < maxLiveRamps) {
+                liveRamps[r] = { v.node, v.index, from.d, v.value.d, 0, rampLength };
+                numLiveRamps = std::max(numLiveRamps, r + 1);
+                return;
+            }
+        }
+        Runner::setLiveValue(currentRunner, v.node, v.index, v.value);
+        Runner::setLiveValue(fadingRunner, v.node, v.index, v.value);
+    };
+    for (int i = 0; i < size1; ++i) apply(liveValues[start1 + i]);
+    for (int i = 0; i < size2; ++i) apply(liveValues[start2 + i]);
+    liveFifo.finishedRead(size1 + size2);
+}
+
+void WaviateFlow2025AudioProcessor::advanceLiveRamps(int samples) noexcept
+{
+    for (int r = 0; r < numLiveRamps; ) {
+        LiveRamp& ramp = liveRamps[r];
+        ramp.done = std::min(ramp.length, ramp.done + samples);
+        const ddtype value = ramp.from + (ramp.to - ramp.from) * double(ramp.done) / double(ramp.length);
+        Runner::setLiveValue(currentRunner, ramp.node, ramp.index, value);
+        Runner::setLiveValue(fadingRunner, ramp.node, ramp.index, value);
+        if (ramp.done == ramp.length) ramp = liveRamps[--numLiveRamps];
+        else ++r;
+    }
+}
+
+// message thread, called by the compiler. the runner may have been replaced since it was submitted,
+// in which case it's either gone or on its way out and the kernel isn't worth installing
+void WaviateFlow2025AudioProcessor::installKernel(RunnerInput* runner, NodeFn kernel)
+{
+    if (ownedRunners.empty() || ownedRunners.back().get() != runner) return; // the newest is always last
+    runner->compiledFunc.store(kernel, std::memory_order_release);
 }
 
 SceneData* WaviateFlow2025AudioProcessor::getAudibleScene() { return audibleScene; }
@@ -510,12 +1247,88 @@ uint64_t WaviateFlow2025AudioProcessor::getCurrentLoadedUserIndex()
     return currentLoadedUserIndex;
 }
 
+bool WaviateFlow2025AudioProcessor::initializeScenesAffectedBy(SceneData* changed, bool parentsToo)
+{
+    std::unordered_set<const SceneData*> affected{ changed };
+    for (bool grew = parentsToo; grew; ) {
+        grew = false;
+        for (auto& scene : scenes) {
+            if (affected.contains(scene.get())) continue;
+            for (NodeData* node : scene->nodeDatas) {
+                const SceneData* sub = node->getType()->fromScene;
+                if (sub && affected.contains(sub)) {
+                    affected.insert(scene.get());
+                    grew = true;
+                    break;
+                }
+            }
+        }
+    }
+    initializeScenes(affected);
+    displaySceneName();
+    return affected.contains(audibleScene);
+}
+
 void WaviateFlow2025AudioProcessor::initializeAllScenes()
 {
+    std::unordered_set<const SceneData*> all;
+    for (auto& scene : scenes) all.insert(scene.get());
+    initializeScenes(all);
+    displaySceneName();
+}
+
+void WaviateFlow2025AudioProcessor::initializeScenes(const std::unordered_set<const SceneData*>& which)
+{
+    // leaves first: a scene sits one level above the deepest scene it embeds that is being rebuilt
+    // too, so those are done by the time it compiles. scenes on one level only share the compiledFor
+    // caches of finished scenes, which lock, and compile on the pool
+    std::unordered_map<const SceneData*, int> level;
     for (auto& scene : scenes) {
-        Runner::initialize(*scene, scene.get(), std::vector<std::span<ddtype>>());
+        if (which.contains(scene.get())) level[scene.get()] = 0;
+    }
+    for (size_t pass = 0; pass < scenes.size(); ++pass) { // bounded, scenes embedding each other stop rising
+        bool raised = false;
+        for (auto& [scene, l] : level) {
+            for (NodeData* node : scene->nodeDatas) {
+                const SceneData* sub = node->getType()->fromScene;
+                auto it = sub && sub != scene ? level.find(sub) : level.end();
+                if (it != level.end() && it->second + 1 > l) {
+                    l = it->second + 1;
+                    raised = true;
+                }
+            }
+        }
+        if (!raised) break;
+    }
+
+    std::map<int, std::vector<SceneData*>> byLevel;
+    for (auto& scene : scenes) {
+        if (auto it = level.find(scene.get()); it != level.end()) byLevel[it->second].push_back(scene.get());
+    }
+    for (auto& [l, batch] : byLevel) {
+        if (batch.size() == 1) {
+            Runner::initialize(*batch[0], batch[0], std::vector<std::span<ddtype>>());
+            continue;
+        }
+        // a job that throws still counts down, what it threw comes out here like it would have serially
+        std::latch done((std::ptrdiff_t)batch.size());
+        std::vector<std::exception_ptr> failures(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            scenePool.addJob([scene = batch[i], failure = &failures[i], &done] {
+                try {
+                    Runner::initialize(*scene, scene, std::vector<std::span<ddtype>>());
+                }
+                catch (...) {
+                    *failure = std::current_exception();
+                }
+                done.count_down();
+            });
+        }
+        done.wait();
+        for (const std::exception_ptr& failure : failures) {
+            if (failure) std::rethrow_exception(failure);
+        }
     }
-    displaySceneName();
 }
 
 void WaviateFlow2025AudioProcessor::displaySceneName() {
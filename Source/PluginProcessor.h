@@ -14,14 +14,14 @@
 #include "Runner.h"
 #include "UserData.h"
 #include "RunnerInput.h"
+#include "RunnerCompiler.h"
+#include "BranchPool.h"
 #include "Registry.h"
 #include "DawManager.h"
 //==============================================================================
 /**
 */
 
-#define nBufferSize 4
-
 class WaviateFlow2025AudioProcessor  : public juce::AudioProcessor
 {
     class SceneComponent* activeScene;
@@ -91,14 +91,44 @@ public:
     SceneComponent* getActiveScene();
     double maxOutBeforeDistortion = 10.0;
     static WaviateFlow2025AudioProcessor* GetActiveInstance();
-    //std::deque<std::unique_ptr<RunnerInput>> runners;
-    std::array<RunnerInput, nBufferSize> runners;
-    std::atomic_int runnerIndex;
+    // runner publication: the message thread builds and warms a runner off to the side and publishes
+    // it through pendingRunner. processBlock picks it up, fades from the old one and hands the old one
+    // back through retiredRunners once the fade is over. only the message thread ever frees a runner
     const RunnerInput* getCurrentRunner() const noexcept;
     const RunnerInput* getPreviousRunner() const noexcept;
     
     void swapToNextRunner();
+    void reclaimRetiredRunners();
+    // message thread: new values for a live node (NodeType::liveValues), written into the playing
+    // runner's field (and its custom nodes' instances) at the start of the next block instead of
+    // recompiling. false when the newest runner has no slot for the node, one of another size, or the
+    // fifo is full, the caller recompiles then
+    bool pushLiveValues(const NodeData* node, std::span<const ddtype> values);
+    // message thread, opt-in: live decimal outputs glide to a pushed value over this long, a sample at a
+    // time, instead of jumping at the next block. 0 jumps. tables always jump
+    void setLiveSmoothing(double seconds) { liveSmoothingSeconds.store(std::max(0.0, seconds), std::memory_order_relaxed); }
+    double getLiveSmoothing() const noexcept { return liveSmoothingSeconds.load(std::memory_order_relaxed); }
+    static constexpr double defaultLiveSmoothingSeconds = 0.020;
+    // message thread, opt-in: the front of every frame renders a block ahead of the rest on another core
+    // (see processBlockPipelined). the audible runner is rebuilt for it and the host told about the
+    // extra block of latency
+    void setPipelined(bool shouldPipeline);
+    bool isPipelined() const noexcept { return pipelineRequested.load(std::memory_order_relaxed); }
+    // MIDI events the pipelined path had no room for since the plugin was created. note-offs only go
+    // once everything else this block has made way for them
+    int getDroppedMidiEventCount() const noexcept { return midiEventsDropped.load(std::memory_order_relaxed); }
+    // message thread, opt-in: every note plays on an instance of the scene of its own, up to the voice
+    // limit (past it the note released longest ago, else the one held longest, gives up its voice). the
+    // voices render side by side on branchPool and are summed, see renderVoices. the audible runner is
+    // rebuilt for it. takes over from pipelined rendering while both are on
+    void setPolyphonic(bool shouldBePolyphonic);
+    bool isPolyphonic() const noexcept { return polyphonyRequested.load(std::memory_order_relaxed); }
+    void setVoiceLimit(int limit);
+    int getVoiceLimit() const noexcept { return voiceLimit.load(std::memory_order_relaxed); }
+    static constexpr int maxVoices = 16;
     static constexpr double fadeWindowSeconds = 0.020;
+    static constexpr int maxRetiredRunners = 8; // pending + current + fading can be in flight, with room to spare
+    static constexpr int maxSubBlockSamples = 64; // upper bound between block-rate node updates
     static constexpr int bufferSize = 96000;
     std::array<float, bufferSize> ring;
     juce::AbstractFifo fifo{ bufferSize };
@@ -106,7 +136,10 @@ public:
     std::optional<UserData> currentLogin;
     uint16_t getCurrentLoadedTypeIndex();
     uint64_t getCurrentLoadedUserIndex();
-    void initializeAllScenes();
+    // reinitializes the changed scene and, unless only its own plan moved, every scene embedding it
+    // as a custom node, directly or further up. returns whether the audible scene was among them
+    bool initializeScenesAffectedBy(SceneData* changed, bool parentsToo = true);
+    void initializeAllScenes(); // after loading a project
     void displaySceneName();
     DawManager dawManager;
 protected:
@@ -122,6 +155,137 @@ private:
     uint64_t currentLoadedUserIndex = 1;
     class SceneData* audibleScene;
     juce::AudioBuffer<double> dbuff;
+
+    std::vector<std::unique_ptr<RunnerInput>> ownedRunners; // message thread only
+    std::atomic<RunnerInput*> pendingRunner{ nullptr };
+    RunnerInput* currentRunner = nullptr; // audio thread only
+    RunnerInput* fadingRunner = nullptr;  // audio thread only
+    int fadeSamplesDone = 0;              // audio thread only
+    std::array<RunnerInput*, maxRetiredRunners> retiredRunners{};
+    juce::AbstractFifo retiredFifo{ maxRetiredRunners };
+    void retireRunner(RunnerInput* runner) noexcept;
+    RunnerCompiler compiler;              // JIT builds of the current runner, swapped in when done
+    struct LiveValue {
+        const NodeData* node;
+        int index;
+        ddtype value;
+        bool glides;                      // a decimal output, see setLiveSmoothing
+    };
+    static constexpr int maxLiveValues = 16384; // a whole custom curve at its largest, twice over
+    std::array<LiveValue, maxLiveValues> liveValues{};
+    juce::AbstractFifo liveFifo{ maxLiveValues };
+    void applyLiveValues() noexcept;      // audio thread
+    std::atomic<double> liveSmoothingSeconds{ 0.0 };
+    struct LiveRamp {
+        const NodeData* node;
+        int index;
+        double from;
+        double to;
+        int done;
+        int length;
+    };
+    static constexpr int maxLiveRamps = 256; // past it a value jumps
+    std::array<LiveRamp, maxLiveRamps> liveRamps{};
+    int numLiveRamps = 0;                 // audio thread only
+    void advanceLiveRamps(int samples) noexcept; // audio thread, after that many samples
+    // wide frames run their independent branches side by side, see Runner::runSampleRate
+    static constexpr int maxBranchWorkers = 7;
+    BranchPool branchPool;
+    // one sample frame of the audible runners: the output of both at the crossfade's gain
+    void addRunnerOutput(const RunnerInput* runner, UserInput& input, double gain, const ddtype* boundary, double& l, double& r) noexcept;
+    // reads: the InputRead flags of the runners playing the frame, UserInput is only kept up that far
+    void finishFrame(double& l, double& r, uint32_t reads) noexcept;
+    void advanceFrame(UserInput& input, const double* samples, int sample, uint32_t reads) noexcept;
+    static uint32_t inputReads(const RunnerInput* runner, const RunnerInput* prevRunner) noexcept;
+    // how far each note's phase moves per frame at noteCycleRate, already wrapped into [0, 1)
+    std::array<double, MIDI_NOTE_COUNT> noteCycleSteps{};
+    double noteCycleRate = 0.0;
+    void updateNoteCycleSteps(double sampleRate) noexcept;
+    bool recordingHistories = false; // a gap in the histories empties them, see finishFrame
+    // message thread: the storage the newest runner's histories went into, handed on to the next runner
+    // of the same size. audio thread: adoptHistories points userInput at a runner's storage
+    std::shared_ptr<std::vector<double>> historyStorage;
+    void adoptHistories(const RunnerInput* runner) noexcept;
+    // at the start of every sub-block, after its MIDI: the lanes the runners playing it compute
+    void updateActiveLanes(UserInput& input, const RunnerInput* runner, const RunnerInput* prevRunner) noexcept;
+    // pipelined rendering: every frame goes through a ring, with its input samples, the runners playing
+    // it and the values its front (RunnerInput::pipelineCut) left for the back. the front renders a
+    // block ahead on frontInput while the back plays the block before, both on branchPool
+    struct PipelineFrame {
+        RunnerInput* runner = nullptr;
+        RunnerInput* prevRunner = nullptr;
+        double alpha = 1.0;
+        double input[4] = {}; // left, right, sidechain left, right
+    };
+    struct PipelineEvent {
+        juce::int64 frame = 0;
+        juce::MidiMessage message;
+    };
+    static constexpr int maxPipelineEvents = 1024;
+    static constexpr int pipelineNoteOffReserve = 256; // the last slots of the ring, only note-offs get them
+    std::atomic<bool> pipelineRequested{ false };
+    bool pipelineActive = false;            // audio thread, follows pipelineRequested between blocks
+    int pipelineLatency = 0;                // samples, the block size prepareToPlay promised
+    juce::int64 pipelineFrame = 0;          // the next frame the front renders, the back is pipelineLatency behind
+    juce::int64 pipelineStart = 0;          // the back plays silence before this one
+    std::vector<PipelineFrame> pipelineFrames; // a power of two, indexed by frame
+    std::vector<ddtype> pipelineValues;     // two RunnerInput::maxPipelineBoundary slices per frame, runner and prevRunner
+    std::array<PipelineEvent, maxPipelineEvents> pipelineEvents;
+    juce::int64 pipelineEventsWritten = 0;
+    juce::int64 frontEventsRead = 0;
+    juce::int64 backEventsRead = 0;
+    std::atomic<int> midiEventsDropped{ 0 };
+    bool makeRoomForNoteOff(juce::int64 blockFirstEvent) noexcept;
+    RunnerInput* backRunner = nullptr;      // what the back played last. retired once no frame refers to it
+    RunnerInput* backPrevRunner = nullptr;
+    std::unique_ptr<UserInput> frontInput;  // the front's, a block ahead of userInput
+    void startPipeline() noexcept;
+    void stopPipeline() noexcept;
+    void processBlockPipelined(const double* const* inputs, const juce::MidiBuffer& midi, int numSamples, double* outL, double* outR) noexcept;
+    void renderPipelineStage(bool front, int numSamples, double* outL, double* outR) noexcept;
+    struct PipelineJob {
+        WaviateFlow2025AudioProcessor* processor;
+        int numSamples;
+        double* outL;
+        double* outR;
+    };
+    static void runPipelineStage(void* context, int task);
+    PipelineFrame& pipelineFrameAt(juce::int64 frame) noexcept;
+    std::span<ddtype> pipelineValuesAt(juce::int64 frame, int slot) noexcept;
+    // polyphonic rendering: the note each voice plays. the voices of every runner follow it
+    struct Voice {
+        int note = -1;             // free when -1
+        bool held = false;
+        double velocity = 0.0;
+        juce::int64 started = 0;   // frames
+        juce::int64 released = 0;
+    };
+    std::atomic<bool> polyphonyRequested{ false };
+    std::atomic<int> voiceLimit{ 8 };
+    std::array<Voice, maxVoices> voices{};
+    std::array<int, maxVoices> playingVoices{}; // this sub-block's, ascending
+    int numPlayingVoices = 0;
+    // a sub-block of every voice: left and right from runner, then from prevRunner, per sample
+    std::array<std::array<double, maxSubBlockSamples * 4>, maxVoices> voiceOutput{};
+    static bool hasVoices(const RunnerInput* runner) noexcept { return runner && !runner->voices.empty(); }
+    static double releaseTailFrames(const RunnerInput* runner, const RunnerInput* prevRunner, double sampleRate) noexcept;
+    void handleVoiceMidi(const juce::MidiMessage& message, const RunnerInput* runner, const RunnerInput* prevRunner) noexcept;
+    void adoptVoices(const RunnerInput* runner) noexcept;
+    void renderVoices(const RunnerInput* runner, const RunnerInput* prevRunner, const double* const* inputs, int start, int end) noexcept;
+    void addVoicesOutput(int slot, int index, double gain, double& l, double& r) const noexcept;
+    struct VoiceJob {
+        WaviateFlow2025AudioProcessor* processor;
+        const RunnerInput* runners[2];
+        const double* const* inputs;
+        int start;
+        int end;
+    };
+    static void runVoiceTask(void* context, int task);
+    void renderVoice(int voice, const VoiceJob& job) noexcept;
+    // independent scenes compile side by side, see initializeScenes
+    juce::ThreadPool scenePool{ juce::jmax(1, juce::SystemStats::getNumCpus() - 1) };
+    void initializeScenes(const std::unordered_set<const SceneData*>& which);
+    void installKernel(RunnerInput* runner, NodeFn kernel);
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaviateFlow2025AudioProcessor)
 };
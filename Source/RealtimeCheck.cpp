@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.cpp
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#endif
+
+namespace realtime {
+    namespace {
+        struct Site {
+            const char* name;
+            const char* file;
+            int line;
+        };
+        constexpr int maxSiteDepth = 32;
+
+        thread_local int audioThreadDepth = 0;
+        thread_local int allowanceDepth = 0;
+        thread_local bool reporting = false;
+        thread_local Site sites[maxSiteDepth];
+        thread_local int siteDepth = 0;
+
+        std::atomic<int> violationCount{ 0 };
+        char lastViolation[512] = {};
+    }
+
+    ScopedAudioThread::ScopedAudioThread() noexcept { ++audioThreadDepth; }
+    ScopedAudioThread::~ScopedAudioThread() noexcept { --audioThreadDepth; }
+
+    ScopedSite::ScopedSite(const char* name, const char* file, int line) noexcept {
+        if (siteDepth < maxSiteDepth) {
+            sites[siteDepth] = { name, file, line };
+        }
+        ++siteDepth;
+    }
+    ScopedSite::~ScopedSite() noexcept { --siteDepth; }
+
+    ScopedAllowance::ScopedAllowance() noexcept { ++allowanceDepth; }
+    ScopedAllowance::~ScopedAllowance() noexcept { --allowanceDepth; }
+
+    bool isOnAudioThread() noexcept { return audioThreadDepth > 0; }
+
+    void reportViolation(const char* what) noexcept {
+        if (audioThreadDepth == 0 || allowanceDepth > 0 || reporting) return;
+        reporting = true; // the assertion logging below allocates itself
+
+        const Site* site = siteDepth > 0 ? &sites[std::min(siteDepth, maxSiteDepth) - 1] : nullptr;
+        std::snprintf(lastViolation, sizeof(lastViolation), "%s on the audio thread in %s (%s:%d)",
+            what, site ? site->name : "processBlock", site ? site->file : "?", site ? site->line : 0);
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+        jassertfalse; // see getLastViolation(), or just walk up the call stack
+
+        reporting = false;
+    }
+
+    int getViolationCount() noexcept { return violationCount.load(std::memory_order_relaxed); }
+    const char* getLastViolation() noexcept { return lastViolation; }
+}
+
+#if WAVIATE_REALTIME_CHECKS
+#if defined(_MSC_VER) && defined(_DEBUG)
+// the debug CRT sees malloc/realloc/free and everything operator new does on top of them
+static int realtimeAllocHook(int allocType, void*, size_t, int blockType, long, const unsigned char*, int) {
+    if (blockType == _CRT_BLOCK) return TRUE; // the CRT's own bookkeeping
+    switch (allocType) {
+    case _HOOK_ALLOC:   realtime::reportViolation("malloc"); break;
+    case _HOOK_REALLOC: realtime::reportViolation("realloc"); break;
+    case _HOOK_FREE:    realtime::reportViolation("free"); break;
+    }
+    return TRUE;
+}
+
+static const bool realtimeAllocHookInstalled = [] {
+    _CrtSetAllocHook(realtimeAllocHook);
+    return true;
+}();
+#else
+void* operator new(std::size_t size) {
+    realtime::reportViolation("operator new");
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    realtime::reportViolation("operator new[]");
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    realtime::reportViolation("operator new");
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    realtime::reportViolation("operator new[]");
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept {
+    if (p) realtime::reportViolation("operator delete");
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    if (p) realtime::reportViolation("operator delete[]");
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete[](p); }
+
+// the aligned forms, AlignedAllocator's (field and its copies) included
+static void* alignedMalloc(std::size_t size, std::align_val_t alignment) noexcept {
+#ifdef _MSC_VER
+    return _aligned_malloc(size ? size : 1, (std::size_t)alignment);
+#else
+    void* p = nullptr;
+    const std::size_t a = std::max((std::size_t)alignment, sizeof(void*));
+    return posix_memalign(&p, a, size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+static void alignedFree(void* p) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    realtime::reportViolation("operator new");
+    if (void* p = alignedMalloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    realtime::reportViolation("operator new[]");
+    if (void* p = alignedMalloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    realtime::reportViolation("operator new");
+    return alignedMalloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    realtime::reportViolation("operator new[]");
+    return alignedMalloc(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    if (p) realtime::reportViolation("operator delete");
+    alignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    if (p) realtime::reportViolation("operator delete[]");
+    alignedFree(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete[](p, alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete[](p, alignment); }
+#endif
+#endif
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <mutex>
+
+// Realtime contract: everything reachable from processBlock (Runner::runBlockRate / runSampleRate / runChannel /
+// run / runClang and every NodeType::execute they call) is on the audio thread. None of it may
+// allocate, free, lock or do I/O; whatever it needs is sized up front by Runner::initialize or
+// prepareToPlay.
+//
+// Build with WAVIATE_REALTIME_CHECKS=1 to enforce it. Heap calls (operator new/delete everywhere,
+// plus malloc/free through the debug CRT on MSVC) and CheckedMutex locks made while a
+// REALTIME_AUDIO_SCOPE is active get counted, stored with the innermost REALTIME_SITE and jassert,
+// so the debugger stops right at the offending call. The locks next to the audio path (RunnerCompiler,
+// KernelCache) are CheckedMutexes. The test project (Tests/WaviateFlowTests.jucer) builds with it on,
+// its RealtimeCheckTest plays a scene through processBlock and expects no violations.
+#ifndef WAVIATE_REALTIME_CHECKS
+#define WAVIATE_REALTIME_CHECKS 0
+#endif
+
+namespace realtime {
+    class ScopedAudioThread {
+    public:
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+    };
+
+    class ScopedSite {
+    public:
+        ScopedSite(const char* name, const char* file, int line) noexcept;
+        ~ScopedSite() noexcept;
+    };
+
+    // for the odd audio-thread path that is allowed to hit the heap (e.g. a one-off debug dump)
+    class ScopedAllowance {
+    public:
+        ScopedAllowance() noexcept;
+        ~ScopedAllowance() noexcept;
+    };
+
+    bool isOnAudioThread() noexcept;
+    void reportViolation(const char* what) noexcept;
+    int getViolationCount() noexcept;
+    const char* getLastViolation() noexcept;
+
+    // drop-in for std::mutex on anything the audio thread could see. try_lock stays legal,
+    // a blocking lock from the audio thread is reported in instrumented builds
+    class CheckedMutex {
+    public:
+        void lock() {
+#if WAVIATE_REALTIME_CHECKS
+            reportViolation("mutex lock");
+#endif
+            m.lock();
+        }
+        bool try_lock() { return m.try_lock(); }
+        void unlock() { m.unlock(); }
+    private:
+        std::mutex m;
+    };
+}
+
+#if WAVIATE_REALTIME_CHECKS
+#define REALTIME_AUDIO_SCOPE() realtime::ScopedAudioThread realtimeAudioScope
+#define REALTIME_SITE() realtime::ScopedSite realtimeSite(__FUNCTION__, __FILE__, __LINE__)
+#define REALTIME_SITE_NAMED(name) realtime::ScopedSite realtimeSite(name, __FILE__, __LINE__)
+#else
+#define REALTIME_AUDIO_SCOPE()
+#define REALTIME_SITE()
+#define REALTIME_SITE_NAMED(name)
+#endif
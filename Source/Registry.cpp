@@ -88,7 +88,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                                     }
 
                                 if (auto* s = comp.getOwningScene())
-                                    s->onSceneChanged();
+                                    s->onSceneChanged(&node);
 
                                 comp.repaint();
                             });
@@ -156,8 +156,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                         comp.getWidth() - 2 * padding, lblH);
             };
 
+        audioFileInputType.emitCode = emitStoredAudio();
         audioFileInputType.outputType = InputType::decimal;
         audioFileInputType.alwaysOutputsRuntimeData = true; // outputs actual audio data at run time
+        audioFileInputType.isBlockRate = true;
         audioFileInputType.fromScene = nullptr;
 
         registry.push_back(audioFileInputType);
@@ -181,6 +183,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             for (int i = 0; i < static_cast<int>(inputs[0].size()); ++i) output[i].d = std::sin(inputs[0][i].d);
         };
+    sinType.emitCode = emitUnary("sin(x)");
+    sinType.laneWise = true;
     sinType.outputType = InputType::decimal;
     sinType.alwaysOutputsRuntimeData = false;
     sinType.fromScene = nullptr;
@@ -200,6 +204,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             for (int i = 0; i < static_cast<int>(inputs[0].size()); ++i) output[i].d = std::cos(inputs[0][i].d);
         };
+    cosType.emitCode = emitUnary("cos(x)");
+    cosType.laneWise = true;
     cosType.outputType = InputType::decimal;
     cosType.alwaysOutputsRuntimeData = false;
     cosType.fromScene = nullptr;
@@ -219,6 +225,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             for (int i = 0; i < static_cast<int>(inputs[0].size()); ++i) output[i].d = std::tan(inputs[0][i].d);
         };
+    tanType.emitCode = emitUnary("tan(x)");
+    tanType.laneWise = true;
     tanType.outputType = InputType::decimal;
     tanType.alwaysOutputsRuntimeData = false;
     tanType.fromScene = nullptr;
@@ -246,6 +254,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             if (yIsBigger) for (int i = n; i < m; ++i) output[i] = inputs[0][i].d;
             else           for (int i = n; i < m; ++i) output[i] = inputs[1][i].d;
         };
+    atan2Type.emitCode = emitFixed(emitPadded("atan2(a, b)"));
     atan2Type.outputType = InputType::decimal;
     atan2Type.alwaysOutputsRuntimeData = false;
     atan2Type.fromScene = nullptr;
@@ -259,9 +268,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
     constantType.tooltip = "Outputs a fixed numeric value.";
     constantType.inputs = {};
     constantType.getOutputSize = outputSize1Known;
+    constantType.propertySlots = { "value" };
     constantType.execute = [](const NodeData& node, UserInput&, const std::vector<std::span<ddtype>>&, std::span<ddtype> output, const RunnerInput& inlineInstance)
         {
-            output[0] = node.getNumericProperty("value");
+            output[0] = node.getSlot(0);
         };
     constantType.buildUI = [](NodeComponent& comp, NodeData& node)
         {
@@ -302,7 +312,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                             el->setText(juce::String(node.getNumericProperty("value")));
                         }
                     }
-                    comp.getOwningScene()->onSceneChanged();
+                    comp.getOwningScene()->onLiveValuesChanged(&node);
                 };
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
             const float sides = 20.0f * scale;
@@ -324,8 +334,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             }
 
             
+        };
+    constantType.emitCode = [](NodeData& nd, int) {
+            return "o[0].d = " + emitNumericLiteral(nd.getNumericProperty("value")) + ";";
         };
     constantType.outputType = InputType::decimal;
+    constantType.liveValues = NodeType::LiveValues::output;
     constantType.alwaysOutputsRuntimeData = false;
     constantType.fromScene = nullptr;
     registry.push_back(constantType);
@@ -400,7 +414,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                         node.setProperty("size", 1.0);
 
                     comp.updateSize();                         // trigger resize
-                    comp.getOwningScene()->onSceneChanged();   // notify scene
+                    comp.getOwningScene()->onLiveValuesChanged(&node);   // recompiles if the size changed
                 };
 
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
@@ -424,7 +438,17 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             back->applyFontToAllText(back->getFont().withHeight(14 * scale));
         }
     };
+    constantVecType.emitCode = [](NodeData& nd, int) {
+            std::string values;
+            int n = 0;
+            for (; nd.getNumericProperties().contains(std::to_string(n)); ++n) {
+                values += emitNumericLiteral(nd.getNumericProperty(std::to_string(n))) + ", ";
+            }
+            if (n == 0) return std::string("for (int k = 0; k < osize; ++k) o[k].d = 0.0;");
+            return "{ static const double v[] = { " + values + "}; for (int k = 0; k < osize; ++k) o[k].d = k < " + std::to_string(n) + " ? v[k] : 0.0; }";
+        };
     constantVecType.outputType = InputType::decimal;
+    constantVecType.liveValues = NodeType::LiveValues::output;
     constantVecType.alwaysOutputsRuntimeData = false;
     constantVecType.fromScene = nullptr;
     registry.push_back(constantVecType);
@@ -437,9 +461,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
     constBoolType.tooltip = "Outputs a fixed boolean (1 or 0).";
     constBoolType.inputs = {};
     constBoolType.getOutputSize = outputSize1Known;
+    constBoolType.propertySlots = { "value" };
     constBoolType.execute = [](const NodeData& node, UserInput&, const std::vector<std::span<ddtype>>&, std::span<ddtype> output, const RunnerInput& inlineInstance)
         {
-            output[0] = node.getNumericProperty("value");
+            output[0] = node.getSlot(0);
         };
     constBoolType.buildUI = [](NodeComponent& comp, NodeData& node)
         {
@@ -449,7 +474,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 {
                     auto el = dynamic_cast<juce::ToggleButton*>(comp.inputGUIElements.back().get());
                     node.setProperty("value", el->getToggleState() ? 1.0 : 0.0);
-                    comp.getOwningScene()->onSceneChanged();
+                    comp.getOwningScene()->onLiveValuesChanged(&node);
                 };
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
             const float sides = 20.0f * scale;
@@ -466,7 +491,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             const float cornerSize = 24.0f * scale;
             back->setBounds(sides, cornerSize, comp.getWidth() - sides - sides, comp.getHeight() - cornerSize * 2);
         };
+    constBoolType.emitCode = [](NodeData& nd, int) {
+            return "o[0].d = " + emitNumericLiteral(nd.getNumericProperty("value")) + ";";
+        };
     constBoolType.outputType = InputType::boolean;
+    constBoolType.liveValues = NodeType::LiveValues::output;
     constBoolType.alwaysOutputsRuntimeData = false;
     constBoolType.fromScene = nullptr;
     registry.push_back(constBoolType);
@@ -494,6 +523,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             else
                 for (int i = 0; i < n; ++i) output[i] = inputs[1][i];
         };
+    branchType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) o[k].d = 0.0;
+            const int n = isize0 < isize1 ? isize0 : isize1;
+            const ddtype* src = isize2 > 0 && i2[0].i != 0 ? i0 : i1;
+            for (int k = 0; k < n; ++k) o[k] = src[k];
+        )");
     branchType.outputType = InputType::decimal;
     branchType.alwaysOutputsRuntimeData = false;
     branchType.fromScene = nullptr;
@@ -539,6 +574,15 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 output[i] = at(src, i);
             }
         };
+    comparisonType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) {
+                const double a = isize3 == 0 ? 0.0 : isize3 == 1 ? i3[0].d : i3[k].d;
+                const double b = isize4 == 0 ? 0.0 : isize4 == 1 ? i4[0].d : i4[k].d;
+                const ddtype* src = a < b ? i0 : a > b ? i2 : i1;
+                const int n = a < b ? isize0 : a > b ? isize2 : isize1;
+                o[k].d = n == 0 ? 0.0 : n == 1 ? src[0].d : src[k].d;
+            }
+        )");
     comparisonType.outputType = InputType::decimal;
     comparisonType.alwaysOutputsRuntimeData = false;
     comparisonType.fromScene = nullptr;
@@ -570,6 +614,16 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 }
             }
         };
+    lerpType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) o[k].d = 0.0;
+            if (isize2 > 0) {
+                const int n = isize0 < isize1 ? isize0 : isize1;
+                double f = 1.0 < i2[0].d ? 1.0 : i2[0].d;
+                f = 0.0 < f ? f : 0.0;
+                const double inv = 1.0 - f;
+                for (int k = 0; k < n; ++k) o[k].d = i0[k].d * inv + i1[k].d * f;
+            }
+        )");
     lerpType.outputType = InputType::decimal;
     lerpType.alwaysOutputsRuntimeData = false;
     lerpType.fromScene = nullptr;
@@ -616,6 +670,19 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             }
         };
 
+    smoothLerpType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) o[k].d = 0.0;
+            const int n = isize0 < isize1 ? isize0 : isize1;
+            if (n > 0 && isize2 > 0) {
+                double s = i2[0].d;
+                if (!isfinite(s)) s = 0.0;
+                if (s < 0.0) s = 0.0;
+                else if (s > 1.0) s = 1.0;
+                const double smooth = s * s * (3.0 - 2.0 * s);
+                const double inv = 1.0 - smooth;
+                for (int k = 0; k < n; ++k) o[k].d = i0[k].d * inv + i1[k].d * smooth;
+            }
+        )");
     smoothLerpType.outputType = InputType::decimal;
     smoothLerpType.alwaysOutputsRuntimeData = false;
     smoothLerpType.fromScene = nullptr;
@@ -637,6 +704,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         };
     timeType.buildUI = [](NodeComponent&, NodeData&) {};
     timeType.onResized = [](NodeComponent&) {};
+    timeType.emitCode = emitFixed("o[0].d = (double)(u->numFramesStartOfBlock + u->sampleInBlock) / u->sampleRate;");
     timeType.outputType = InputType::decimal;
     timeType.alwaysOutputsRuntimeData = true;
     timeType.fromScene = nullptr;
@@ -658,6 +726,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < static_cast<int>(inputs[0].size()); ++i)
                 output[i].i = inputs[0][i].i ? 0 : 1;
         };
+    notType.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k].i = i0[k].i ? 0 : 1;");
     notType.outputType = InputType::boolean;
     notType.alwaysOutputsRuntimeData = false;
     notType.fromScene = nullptr;
@@ -682,6 +751,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < n; ++i) output[i].i = (inputs[0][i].i && inputs[1][i].i) ? 1 : 0;
             for (int i = n; i < m; ++i) output[i].i = 0;
         };
+    andType.emitCode = emitFixed(R"(
+            const int n = isize0 < isize1 ? isize0 : isize1;
+            const int m = isize0 < isize1 ? isize1 : isize0;
+            for (int k = 0; k < n; ++k) o[k].i = (i0[k].i && i1[k].i) ? 1 : 0;
+            for (int k = n; k < m; ++k) o[k].i = 0;
+        )");
     andType.outputType = InputType::boolean;
     andType.alwaysOutputsRuntimeData = false;
     andType.fromScene = nullptr;
@@ -709,6 +784,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             if (xIsBigger) for (int i = n; i < m; ++i) output[i] = inputs[0][i];
             else           for (int i = n; i < m; ++i) output[i] = inputs[1][i];
         };
+    orType.emitCode = emitFixed(R"(
+            const int n = isize0 < isize1 ? isize0 : isize1;
+            for (int k = 0; k < n; ++k) o[k].d = (i0[k].i || i1[k].i) ? 1.0 : 0.0;
+            for (int k = n; k < isize0; ++k) o[k] = i0[k];
+            for (int k = n; k < isize1; ++k) o[k] = i1[k];
+        )");
     orType.outputType = InputType::boolean;
     orType.alwaysOutputsRuntimeData = false;
     orType.fromScene = nullptr;
@@ -728,8 +809,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             output[0] = userInput.isStereoRight ? userInput.sideChainR : userInput.sideChainL;
         };
+    sidechainType.emitCode = emitFixed("o[0].d = u->isStereoRight ? u->sideChainR : u->sideChainL;");
     sidechainType.outputType = InputType::decimal;
-    sidechainType.alwaysOutputsRuntimeData = false;
+    sidechainType.alwaysOutputsRuntimeData = true; // live host input, changes every sample
+    sidechainType.dependsOnChannel = true;
     sidechainType.fromScene = nullptr;
     registry.push_back(sidechainType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("alt shift s").getTextDescription(), registry.size() - 1 });
@@ -746,8 +829,9 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             output[0] = userInput.leftInput;
         };
+    leftInType.emitCode = emitFixed("o[0].d = u->leftInput;");
     leftInType.outputType = InputType::decimal;
-    leftInType.alwaysOutputsRuntimeData = false;
+    leftInType.alwaysOutputsRuntimeData = true; // live host input, changes every sample
     leftInType.fromScene = nullptr;
     registry.push_back(leftInType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("shift i").getTextDescription(), registry.size() - 1 });
@@ -764,8 +848,9 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             output[0] = userInput.rightInput;
         };
+    rightInType.emitCode = emitFixed("o[0].d = u->rightInput;");
     rightInType.outputType = InputType::decimal;
-    rightInType.alwaysOutputsRuntimeData = false;
+    rightInType.alwaysOutputsRuntimeData = true; // live host input, changes every sample
     rightInType.fromScene = nullptr;
     registry.push_back(rightInType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("alt i").getTextDescription(), registry.size() - 1 });
@@ -782,8 +867,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         {
             output[0] = userInput.isStereoRight ? userInput.rightInput : userInput.leftInput;
         };
+    stereoInType.emitCode = emitFixed("o[0].d = u->isStereoRight ? u->rightInput : u->leftInput;");
     stereoInType.outputType = InputType::decimal;
-    stereoInType.alwaysOutputsRuntimeData = false;
+    stereoInType.alwaysOutputsRuntimeData = true; // live host input, changes every sample
+    stereoInType.dependsOnChannel = true;
     stereoInType.fromScene = nullptr;
     registry.push_back(stereoInType);
     keyCodeTypeMapping.insert({ juce::KeyPress::createFromDescription("i").getTextDescription(), registry.size() - 1 });
@@ -830,6 +917,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
 
                 }
             };
+        t.emitCode = [](NodeData& nd, int) {
+            const int n = (int)nd.optionalStoredAudio.size();
+            if (n == 0) return std::string("for (int k = 0; k < osize; ++k) o[k].d = 0.0;");
+            return "for (int k = 0; k < osize; ++k) o[k] = stores[k < " + std::to_string(n) + " ? k : " + std::to_string(n - 1) + "];";
+        };
         t.outputType = InputType::decimal;
         t.alwaysOutputsRuntimeData = false;
         t.fromScene = nullptr;
@@ -851,6 +943,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (ddtype v : inputs[0]) s += v.d;
             output[0] = s;
         };
+    sumType.emitCode = emitFixed("{ double s = 0.0; for (int k = 0; k < isize0; ++k) s += i0[k].d; o[0].d = s; }");
+    sumType.laneSum = true;
     sumType.outputType = InputType::decimal;
     sumType.alwaysOutputsRuntimeData = false;
     sumType.fromScene = nullptr;
@@ -871,6 +965,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (ddtype v : inputs[0]) { s += v.d; ++c; }
             output[0] = (c > 0) ? (s / c) : 0.0;
         };
+    avgType.emitCode = emitFixed("{ double s = 0.0; for (int k = 0; k < isize0; ++k) s += i0[k].d; o[0].d = isize0 > 0 ? s / isize0 : 0.0; }");
     avgType.outputType = InputType::decimal;
     avgType.alwaysOutputsRuntimeData = false;
     avgType.fromScene = nullptr;
@@ -892,6 +987,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (ddtype v : inputs[0]) if (v.d > m) m = v.d;
             output[0] = m;
         };
+    maxType.emitCode = emitFixed(R"(
+            double m = isize0 > 0 ? i0[0].d : 0.0;
+            for (int k = 1; k < isize0; ++k) if (i0[k].d > m) m = i0[k].d;
+            o[0].d = m;
+        )");
     maxType.outputType = InputType::decimal;
     maxType.alwaysOutputsRuntimeData = false;
     maxType.fromScene = nullptr;
@@ -913,6 +1013,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (ddtype v : inputs[0]) if (v.d < m) m = v.d;
             output[0] = m;
         };
+    minType.emitCode = emitFixed(R"(
+            double m = isize0 > 0 ? i0[0].d : 0.0;
+            for (int k = 1; k < isize0; ++k) if (i0[k].d < m) m = i0[k].d;
+            o[0].d = m;
+        )");
     minType.outputType = InputType::decimal;
     minType.alwaysOutputsRuntimeData = false;
     minType.fromScene = nullptr;
@@ -934,6 +1039,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             if (idx < 0 || idx >= static_cast<int>(inputs[0].size())) { output[0] = 0.0; return; }
             output[0] = inputs[0][idx];
         };
+    getElemType.emitCode = emitFixed(R"(
+            const int64_t idx = isize1 > 0 ? i1[0].i : -1;
+            if (idx < 0 || idx >= isize0) o[0].d = 0.0;
+            else o[0] = i0[idx];
+        )");
     getElemType.outputType = InputType::any;
     getElemType.alwaysOutputsRuntimeData = false;
     getElemType.fromScene = nullptr;
@@ -954,12 +1064,19 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             const int64_t idx = inputs[1][i].i;
             if (idx < 0 || idx >= static_cast<int>(inputs[0].size())) { output[i] = 0.0; }
             else {
-                output[i] = inputs[0][i];
+                output[i] = inputs[0][idx];
             }
             
         }
         
     };
+    sliceElemType.emitCode = emitFixed(R"(
+            for (int k = 0; k < isize1; ++k) {
+                const int64_t idx = i1[k].i;
+                if (idx < 0 || idx >= isize0) o[k].d = 0.0;
+                else o[k] = i0[idx];
+            }
+        )");
     sliceElemType.outputType = InputType::decimal;
     sliceElemType.alwaysOutputsRuntimeData = false;
     sliceElemType.fromScene = nullptr;
@@ -986,6 +1103,13 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             if (idx < 0 || idx >= n) return;
             output[idx] = inputs[2][0].d;
         };
+    changeElemType.emitCode = emitFixed(R"(
+            if (isize0 > 0 && isize1 > 0 && isize2 > 0) {
+                for (int k = 0; k < isize0; ++k) o[k] = i0[k];
+                const int64_t idx = i1[0].i;
+                if (idx >= 0 && idx < isize0) o[idx].d = i2[0].d;
+            }
+        )");
     changeElemType.outputType = InputType::decimal;
     changeElemType.alwaysOutputsRuntimeData = false;
     changeElemType.fromScene = nullptr;
@@ -1013,6 +1137,13 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             const double step = inputs[2][0].d;
             for (int i = 0; i < stepCount; ++i) { output[i] = value; value += step; }
         };
+    rangeType.emitCode = emitFixed(R"(
+            int64_t stepCount = i1[0].i;
+            if (stepCount < 1) stepCount = 1;
+            double value = i0[0].d;
+            const double step = i2[0].d;
+            for (int k = 0; k < stepCount && k < osize; ++k) { o[k].d = value; value += step; }
+        )");
     rangeType.outputType = InputType::decimal;
     rangeType.alwaysOutputsRuntimeData = false;
     rangeType.fromScene = nullptr;
@@ -1037,6 +1168,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             double value = inputs[0][0].d;
             for (int i = 0; i < output.size(); ++i) { output[i] = value; }
         };
+    repeatType.emitCode = emitFixed("for (int k = 0; k < osize; ++k) o[k].d = i0[0].d;");
     repeatType.outputType = InputType::decimal;
     repeatType.alwaysOutputsRuntimeData = false;
     repeatType.fromScene = nullptr;
@@ -1059,6 +1191,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < static_cast<int>(output.size()); ++i)
                 output[i] = std::sin(2.0 * 3.14159265358979323846 * inputs[0][i].d);
         };
+    sinWaveType.emitCode = emitFixed("for (int k = 0; k < osize; ++k) o[k].d = sin(2.0 * 3.14159265358979323846 * i0[k].d);");
+    sinWaveType.laneWise = true;
     sinWaveType.outputType = InputType::decimal;
     sinWaveType.alwaysOutputsRuntimeData = false;
     sinWaveType.fromScene = nullptr;
@@ -1078,6 +1212,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < static_cast<int>(output.size()); ++i)
                 output[i] = (inputs[0][i].d > 0.5) ? -1.0 : 1.0; // preserves original behavior
         };
+    squareType.emitCode = emitFixed("for (int k = 0; k < osize; ++k) o[k].d = i0[k].d > 0.5 ? -1.0 : 1.0;");
+    squareType.laneWise = true;
     squareType.outputType = InputType::decimal;
     squareType.alwaysOutputsRuntimeData = false;
     squareType.fromScene = nullptr;
@@ -1100,6 +1236,14 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 output[i] = 2.0 * tri - 1.0;
             }
         };
+    triangleType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) {
+                double t = fmod(i0[k].d, 1.0); if (t < 0.0) t += 1.0;
+                const double tri = 1.0 - fabs(2.0 * t - 1.0);
+                o[k].d = 2.0 * tri - 1.0;
+            }
+        )");
+    triangleType.laneWise = true;
     triangleType.outputType = InputType::decimal;
     triangleType.alwaysOutputsRuntimeData = false;
     triangleType.fromScene = nullptr;
@@ -1126,6 +1270,17 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 output[i] = (1.0 - 2.0 * k) * a;
             }
         };
+    circleWaveType.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) {
+                const double x = i0[k].d;
+                const double m = 2.0 * (x - floor(x));
+                const double half = floor(m);
+                const double v = 2.0 * (m - half) - 1.0;
+                const double r = 1.0 - v * v;
+                o[k].d = (1.0 - 2.0 * half) * sqrt(0.0 < r ? r : 0.0);
+            }
+        )");
+    circleWaveType.laneWise = true;
     circleWaveType.outputType = InputType::decimal;
     circleWaveType.alwaysOutputsRuntimeData = false;
     circleWaveType.fromScene = nullptr;
@@ -1162,6 +1317,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 for (int i = 0; i < (int)x.size(); ++i)
                     out[i].d = std::clamp(x[i].d, lo, hi);
             };
+        t.emitCode = emitFixed(R"(
+            const double mn = isize1 == 0 ? 0.0 : i1[0].d, mx = isize2 == 0 ? 1.0 : i2[0].d;
+            const double lo = mx < mn ? mx : mn, hi = mn < mx ? mx : mn;
+            for (int k = 0; k < isize0; ++k) { const double x = i0[k].d; o[k].d = x < lo ? lo : hi < x ? hi : x; }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1184,6 +1344,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 for (int i = 0; i < (int)x.size(); ++i)
                     out[i].d = std::clamp(x[i].d, -1.0, 1.0);
             };
+        t.emitCode = emitUnary("x < -1.0 ? -1.0 : 1.0 < x ? 1.0 : x");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1217,6 +1378,16 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 for (int i = 0; i < (int)x.size(); ++i)
                     out[i].d = wrapTo(x[i].d, lo, hi);
             };
+        t.emitCode = emitFixed(R"(
+            const double mn = isize1 == 0 ? 0.0 : i1[0].d, mx = isize2 == 0 ? 1.0 : i2[0].d;
+            const double lo = mx < mn ? mx : mn, hi = mn < mx ? mx : mn;
+            const double range = hi - lo;
+            for (int k = 0; k < isize0; ++k) {
+                double w = range > 0.0 ? fmod(i0[k].d - lo, range) : 0.0;
+                if (w < 0.0) w += range;
+                o[k].d = lo + w;
+            }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1238,6 +1409,13 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 for (int i = 0; i < (int)x.size(); ++i)
                     out[i].d = wrapTo(x[i].d, -1.0, 1.0);
             };
+        t.emitCode = emitFixed(R"(
+            for (int k = 0; k < isize0; ++k) {
+                double w = fmod(i0[k].d + 1.0, 2.0);
+                if (w < 0.0) w += 2.0;
+                o[k].d = w - 1.0;
+            }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1292,6 +1470,18 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                     out[i].d = m + r * std::tanh(z);
                 }
             };
+        t.emitCode = emitFixed(R"(
+            const double mn = isize1 == 0 ? -1.0 : i1[0].d, mx = isize2 == 0 ? 1.0 : i2[0].d;
+            const double lo = mx < mn ? mx : mn, hi = mn < mx ? mx : mn;
+            const double m = 0.5 * (lo + hi);
+            const double r = 0.5 * (hi - lo);
+            if (!(r > 0.0)) {
+                for (int k = 0; k < isize0; ++k) { const double x = i0[k].d; o[k].d = x < lo ? lo : hi < x ? hi : x; }
+            }
+            else {
+                for (int k = 0; k < isize0; ++k) o[k].d = m + r * tanh((i0[k].d - m) / (r + 1e-12));
+            }
+        )");
         t.outputType = InputType::decimal;
         t.alwaysOutputsRuntimeData = false;
         t.fromScene = nullptr;
@@ -1310,6 +1500,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = std::abs(x[i].d);
             };
+        t.emitCode = emitUnary("fabs(x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1324,6 +1515,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = (x[i].d > 0) ? 1.0 : ((x[i].d < 0) ? -1.0 : 0.0);
             };
+        t.emitCode = emitUnary("x > 0.0 ? 1.0 : x < 0.0 ? -1.0 : 0.0");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1338,6 +1530,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = (x[i].d >= 0.0) ? std::sqrt(x[i].d) : 0.0;
             };
+        t.emitCode = emitUnary("x >= 0.0 ? sqrt(x) : 0.0");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1366,6 +1559,16 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 }
             }
             };
+        t.emitCode = emitFixed(R"(
+            const double n = isize1 == 0 ? 2.0 : i1[0].d;
+            const int odd = fabs(n - round(n)) < 1e-9 && llround(n) % 2 != 0;
+            for (int k = 0; k < isize0; ++k) {
+                const double v = i0[k].d;
+                if (fabs(n) < 1e-12) o[k].d = 0.0;
+                else if (v < 0.0) o[k].d = odd ? -pow(fabs(v), 1.0 / n) : 0.0;
+                else o[k].d = pow(v, 1.0 / n);
+            }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1380,6 +1583,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = std::exp(x[i].d);
             };
+        t.emitCode = emitUnary("exp(x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr;
         registry.push_back(t);
     }
@@ -1392,6 +1596,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.buildUI = [](NodeComponent&, NodeData&) {}; t.onResized = [](NodeComponent&) {};
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) { const double v = std::clamp(x[i].d, -1.0, 1.0); out[i].d = std::asin(v); } };
+        t.emitCode = emitUnary("asin(x < -1.0 ? -1.0 : 1.0 < x ? 1.0 : x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1401,6 +1606,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.buildUI = [](NodeComponent&, NodeData&) {}; t.onResized = [](NodeComponent&) {};
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) { const double v = std::clamp(x[i].d, -1.0, 1.0); out[i].d = std::acos(v); } };
+        t.emitCode = emitUnary("acos(x < -1.0 ? -1.0 : 1.0 < x ? 1.0 : x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1410,6 +1616,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.buildUI = [](NodeComponent&, NodeData&) {}; t.onResized = [](NodeComponent&) {};
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = std::atan(x[i].d); };
+        t.emitCode = emitUnary("atan(x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1424,6 +1631,14 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             const auto& x = in[0]; const double m = in[1].empty() ? 1.0 : in[1][0].d; const double am = std::abs(m);
             for (int i = 0; i < (int)x.size(); ++i) { double r = am > 0 ? std::fmod(x[i].d, am) : 0.0; if (r < 0) r += am; out[i].d = r; }
             };
+        t.emitCode = emitFixed(R"(
+            const double am = fabs(isize1 == 0 ? 1.0 : i1[0].d);
+            for (int k = 0; k < isize0; ++k) {
+                double r = am > 0 ? fmod(i0[k].d, am) : 0.0;
+                if (r < 0) r += am;
+                o[k].d = r;
+            }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1437,6 +1652,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             const auto& x = in[0]; for (int i = 0; i < (int)x.size(); ++i) out[i].d = (x[i].d != 0.0) ? 1.0 / x[i].d : 0.0;
             };
+        t.emitCode = emitUnary("x != 0.0 ? 1.0 / x : 0.0");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1454,6 +1670,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = (av ^ bv) ? 1 : 0;
             }
             };
+        t.emitCode = emitLogic("a != b");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1467,6 +1684,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = v ? 0 : 1;
             }
             };
+        t.emitCode = emitLogic("!(a && b)");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1480,6 +1698,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = v ? 0 : 1;
             }
             };
+        t.emitCode = emitLogic("!(a || b)");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1494,6 +1713,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = (av == bv) ? 1 : 0;
             }
             };
+        t.emitCode = emitLogic("a == b");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1519,16 +1739,24 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             }
             };
         t.whichInputToFollowWildcard = 1;
+        t.emitCode = emitFixed(R"(
+            const int n = isize1 > isize2 ? isize1 : isize2;
+            for (int k = 0; k < n; ++k) {
+                const int c = k < isize0 ? i0[k].i != 0 : 1;
+                if (c) { if (k < isize1) o[k] = i1[k]; else o[k].d = 0.0; }
+                else { if (k < isize2) o[k] = i2[k]; else o[k].d = 0.0; }
+            }
+        )");
         t.outputType = InputType::followsInput; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ========= Comparators: gt/ge/lt/le/eq =========
 
-    makeCmp< [](double a, double b) {return a > b; }>(80,"greater", "x > y (component-wise; padding uses 0).", registry);
-    makeCmp< [](double a, double b) {return a < b; } >(81,"less", "x < y (component-wise; padding uses 0).", registry);
-    makeCmp< [](double a, double b) {return a >= b; } >(82,"greater eq", "x >= y (component-wise; padding uses 0).", registry);
-    makeCmp< [](double a, double b) {return a <= b; } >(83,"less eq", "x <= y (component-wise; padding uses 0).", registry);
-    makeCmp< [](double a, double b) {return a == b; } >(84,"equal", "x == y (component-wise; padding uses 0).", registry);
+    makeCmp< [](double a, double b) {return a > b; }>(80,"greater", "x > y (component-wise; padding uses 0).", "a > b", registry);
+    makeCmp< [](double a, double b) {return a < b; } >(81,"less", "x < y (component-wise; padding uses 0).", "a < b", registry);
+    makeCmp< [](double a, double b) {return a >= b; } >(82,"greater eq", "x >= y (component-wise; padding uses 0).", "a >= b", registry);
+    makeCmp< [](double a, double b) {return a <= b; } >(83,"less eq", "x <= y (component-wise; padding uses 0).", "a <= b", registry);
+    makeCmp< [](double a, double b) {return a == b; } >(84,"equal", "x == y (component-wise; padding uses 0).", "a == b", registry);
 
     //{
     //    NodeType t(84); t.name = "equal"; t.address = "math/logic/compare/"; t.tooltip = "x == y (component-wise; padding uses 0).";
@@ -1549,6 +1777,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = (x[i].d>lo && x[i].d<hi) ? 1 : 0;
             }
         };
+        t.emitCode = emitFixed(R"(
+            double lo = isize1 == 0 ? 0.0 : i1[0].d, hi = isize2 == 0 ? 1.0 : i2[0].d;
+            if (lo > hi) { const double t = lo; lo = hi; hi = t; }
+            for (int k = 0; k < isize0; ++k) { const double x = i0[k].d; o[k].i = (x > lo && x < hi) ? 1 : 0; }
+        )");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1562,6 +1795,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = (x[i].d<lo || x[i].d>hi) ? 1 : 0;
             }
         };
+        t.emitCode = emitFixed(R"(
+            double lo = isize1 == 0 ? 0.0 : i1[0].d, hi = isize2 == 0 ? 1.0 : i2[0].d;
+            if (lo > hi) { const double t = lo; lo = hi; hi = t; }
+            for (int k = 0; k < isize0; ++k) { const double x = i0[k].d; o[k].i = (x < lo || x > hi) ? 1 : 0; }
+        )");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1578,6 +1816,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 }
             out[0].i = any;
             };
+        t.emitCode = emitFixed("{ int64_t r = 0; for (int k = 0; k < isize0; ++k) r |= i0[k].i != 0; o[0].i = r; }");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1592,6 +1831,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 } 
             out[0].i = any;
             };
+        t.emitCode = emitFixed("{ int64_t r = 0; for (int k = 0; k < isize0; ++k) r |= i0[k].i == 0; o[0].i = r; }");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1601,6 +1841,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             int64_t all = 1; for (ddtype v : in[0]) if (v.i == 0) { all = 0; break; } out[0].i = all;
             };
+        t.emitCode = emitFixed("{ int64_t r = 1; for (int k = 0; k < isize0; ++k) r &= i0[k].i != 0; o[0].i = r; }");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1610,6 +1851,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             int64_t all = 1; for (ddtype v : in[0]) if (v.i != 0) { all = 0; break; } out[0].i = all;
             };
+        t.emitCode = emitFixed("{ int64_t r = 1; for (int k = 0; k < isize0; ++k) r &= i0[k].i == 0; o[0].i = r; }");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1621,6 +1863,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 if (v.i != 0) ++c;
             out[0].i = c;
         };
+        t.emitCode = emitFixed("{ int64_t c = 0; for (int k = 0; k < isize0; ++k) c += i0[k].i != 0; o[0].i = c; }");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     {
@@ -1632,6 +1875,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 if (v.i == 0) ++c; 
                 out[0].i = c;
             };
+        t.emitCode = emitFixed("{ int64_t c = 0; for (int k = 0; k < isize0; ++k) c += i0[k].i == 0; o[0].i = c; }");
         t.outputType = InputType::integer; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1654,6 +1898,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (ddtype v : b) out[++idx] = v;
             };
 		t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) { o[k] = i0[k]; } for (int k = 0; k < isize1; ++k) { o[isize0 + k] = i1[k]; }");
         t.outputType = InputType::followsInput; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1680,6 +1925,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < nCopy; ++i) out[i] = x[i];
             for (int i = nCopy; i < N; ++i) out[i] = v;
             };
+        t.emitCode = emitFixed(R"(
+            const int copied = isize0 < osize ? isize0 : osize;
+            for (int k = 0; k < copied; ++k) o[k] = i0[k];
+            for (int k = copied; k < osize; ++k) { if (isize2 > 0) o[k] = i2[0]; else o[k].d = 0.0; }
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1700,6 +1950,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = xs; i < N; ++i) out[i] = { 0.0 };
             };
 		t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0 && k < osize; ++k) { o[k] = i0[k]; } for (int k = isize0; k < osize; ++k) { o[k].d = 0.0; }");
         t.outputType = InputType::followsInput; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1713,6 +1964,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             const auto& x = in[0]; const int n = (int)x.size(); for (int i = 0; i < n; ++i) out[i] = x[n - 1 - i];
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed("for (int k = 0; k < isize0; ++k) o[k] = i0[isize0 - 1 - k];");
         t.outputType = InputType::followsInput; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1735,6 +1987,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             while (ib < nb) out[k++] = b[ib++];
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed(R"(
+            const int n = isize0 < isize1 ? isize0 : isize1;
+            for (int k = 0; k < n; ++k) { o[2 * k] = i0[k]; o[2 * k + 1] = i1[k]; }
+            for (int k = n; k < isize0; ++k) o[n + k] = i0[k];
+            for (int k = n; k < isize1; ++k) o[n + k] = i1[k];
+        )");
         t.outputType = InputType::followsInput; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1752,6 +2010,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 } 
             out[0].i = idx;
         };
+        t.emitCode = emitFixed(R"(
+            int64_t idx = 0;
+            double best = isize0 > 0 ? i0[0].d : 0.0;
+            for (int k = 1; k < isize0; ++k) if (i0[k].d > best) { best = i0[k].d; idx = k; }
+            o[0].i = idx;
+        )");
         t.outputType = InputType::integer; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
     
@@ -1764,6 +2028,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             out[0].i = in[0].size();
         };
+        t.emitCode = emitFixed("o[0].i = isize0;");
         t.outputType = InputType::integer; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1779,10 +2044,22 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             int head = u.isStereoRight ? u.rightInputHistoryHead : u.leftInputHistoryHead;
             int count = u.isStereoRight ? u.rightInputHistorySize : u.leftInputHistorySize;
             for (int i = 1; i < in[1].size(); i += 1) {
-				out[0].d += in[1][i].d * CircleBuffer_get(pastSamples, head, count, i - 1);
+				out[0].d += in[1][i].d * CircleBuffer_get(pastSamples, head, count, u.historyMask, i - 1);
             }
 		};
-        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
+        t.emitCode = emitFixed(emitChannelHistory + R"(
+            double s = i1[0].d * i0[0].d;
+            for (int k = 1; k < isize1; ++k) s += i1[k].d * CircleBuffer_get(past, head, count, mask, k - 1);
+            o[0].d = s;
+        )");
+        // a frame back for every weight past the first
+        t.historyLength = [](const NodeData& nd, const RunnerInput& r) -> int
+            {
+                const NodeData* weights = nd.getInput(1);
+                auto it = weights ? r.safeOwnership.find(const_cast<NodeData*>(weights)) : r.safeOwnership.end();
+                return it == r.safeOwnership.end() ? 0 : std::get<1>(it->second) - 1;
+            };
+        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.dependsOnChannel = true; t.inputReads = readsHistories; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ======== sliding window
@@ -1801,11 +2078,24 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             int count = u.isStereoRight ? u.rightInputHistorySize : u.leftInputHistorySize;
             for (int i = 0; i < n; i += 1) {
                 double v = (1.0 * n - i >= 1) + (n - i) * (n - i < 1);
-                sum += CircleBuffer_get(pastSamples, head, count, i) * v;
+                sum += CircleBuffer_get(pastSamples, head, count, u.historyMask, i) * v;
             }
             out[0].d = sum / n;
         };
-		t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
+		t.emitCode = emitFixed(emitChannelHistory + R"(
+            const double maxFilter = 60;
+            double n = isize0 == 0 ? 0.0 : i1[0].d * maxFilter;
+            n = maxFilter < n ? maxFilter : n;
+            n = 1.0 < n ? n : 1.0;
+            double sum = i0[0].d;
+            for (int k = 0; k < n; ++k) {
+                const double v = (1.0 * n - k >= 1) + (n - k) * (n - k < 1);
+                sum += CircleBuffer_get(past, head, count, mask, k) * v;
+            }
+            o[0].d = sum / n;
+        )");
+        t.historyLength = [](const NodeData&, const RunnerInput&) { return 60; }; // maxFilter
+		t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.dependsOnChannel = true; t.inputReads = readsHistories; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ======== get old samples
@@ -1821,11 +2111,25 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             for (int i = 0; i < in[0].size(); i += 1) {
                 int64_t idx = in[0][i].i;
 
-                out[i] = CircleBuffer_get(pastSamples, head, count, idx);
+                out[i] = CircleBuffer_get(pastSamples, head, count, u.historyMask, (int)std::min<int64_t>(idx, CIRCLEBUFFER_CAPACITY));
             }
 
         };
-        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
+        t.emitCode = emitFixed(emitChannelHistory + " const int64_t furthest = " + std::to_string(CIRCLEBUFFER_CAPACITY) + ";" + R"(
+            for (int k = 0; k < isize0; ++k) o[k].d = CircleBuffer_get(past, head, count, mask, (int)(i0[k].i < furthest ? i0[k].i : furthest));
+        )");
+        // the indices as far as the plan knows them up front, the whole capacity otherwise
+        t.historyLength = [](const NodeData& nd, const RunnerInput& r) -> int
+            {
+                const NodeData* indices = nd.getInput(0);
+                if (!indices) return (int)std::clamp<int64_t>(nd.defaultValues[0].i + 1, 0, CIRCLEBUFFER_CAPACITY);
+                auto it = r.nodeCompileTimeOutputs.find(const_cast<NodeData*>(indices));
+                if (!r.compileTimeKnown.contains(const_cast<NodeData*>(indices)) || it == r.nodeCompileTimeOutputs.end()) return CIRCLEBUFFER_CAPACITY;
+                int64_t furthest = -1;
+                for (ddtype d : it->second) furthest = std::max(furthest, d.i);
+                return (int)std::clamp<int64_t>(furthest + 1, 0, CIRCLEBUFFER_CAPACITY);
+            };
+        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.dependsOnChannel = true; t.inputReads = readsHistories; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ========= set storeable value 
@@ -1847,6 +2151,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             //}
         };
         //t.emitCode = "v" + juce::String(;
+        t.emitCode = emitFixed("o[0].d = i1[0].d;");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1862,6 +2167,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
 			//out[0].d = u.storeableValues.contains(key) ? u.storeableValues.at(key) : 0.0;
         };
 
+        t.emitCode = emitFixed("(void)o; /* keyed storage isn't wired up yet, same as execute */");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1881,7 +2187,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i] = uniform_closed(a, b);
             }
         };
-        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
+        t.emitCode = emitFixed("{ const double a = i0[0].d, b = i1[0].d; for (int k = 0; k < osize; ++k) o[k].d = uniform_closed(a, b); }");
+        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.isNondeterministic = true; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ========= white noise
@@ -1898,7 +2205,8 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i].i = coin_flip();
             }
         };
-        t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
+        t.emitCode = emitFixed("for (int k = 0; k < osize; ++k) o[k].i = coin_flip();");
+        t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = true; t.isNondeterministic = true; t.fromScene = nullptr; registry.push_back(t);
     }
     // ========= deterministic white noise
     {
@@ -1915,6 +2223,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i] = deterministic_uniform_closed(a, b, in[0][i].d);
             }
         };
+        t.emitCode = emitFixed(R"(
+            double a = i1[0].d, b = i2[0].d;
+            if (a > b) { const double t = a; a = b; b = t; }
+            for (int k = 0; k < osize; ++k) o[k].d = deterministic_uniform_closed(a, b, i0[k].d);
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1934,17 +2247,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[0].i = idx;
             }
         };
-        t.emitCode = [](NodeData& nd, int ord) {
-            return "o[0].i = 0;"
-                "int64_t idx = 0;"
-                "double best = i0[0].d;"
-                "for (int i = 0; i < isize0; ++i) {"
-                "   if (i0[i].d < best) {"
-                "       best = i0[i].d; idx = i;"
-                "       o[0].i = idx"
-                "   }"
-                "}";
-        };
+        t.emitCode = emitFixed(R"(
+            int64_t idx = 0;
+            double best = isize0 > 0 ? i0[0].d : 0.0;
+            for (int k = 1; k < isize0; ++k) if (i0[k].d < best) { best = i0[k].d; idx = k; }
+            o[0].i = idx;
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1964,6 +2272,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             }
             
         };
+        t.emitCode = emitFixed(R"(
+            for (int k = 0; k < osize; ++k) {
+                const int x = (int)i0[k].i, d = (int)i1[k].i;
+                o[k].i = d != 0 && x % d == 0;
+            }
+        )");
         t.outputType = InputType::boolean; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1977,6 +2291,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput& u, const std::vector<std::span<ddtype>>&, std::span<ddtype> out, const RunnerInput& r) {
             out[0].i = u.sampleInBlock + u.numFramesStartOfBlock;
         };
+        t.emitCode = emitFixed("o[0].i = u->sampleInBlock + u->numFramesStartOfBlock;");
         t.outputType = InputType::integer; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -1991,7 +2306,9 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             // Expect a field like u.sampleRate (ddtype). Adjust if your API differs.
             out[0].d = u.sampleRate; // e.g., 44100.0 / 48000.0
             };
-        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
+        // host decides the rate, so this can't be folded at compile time
+        t.emitCode = emitFixed("o[0].d = u->sampleRate;");
+        t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.isBlockRate = true; t.fromScene = nullptr; registry.push_back(t);
     }
 
     // ======== value noise (1D, direct mapping)
@@ -2005,6 +2322,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             for (int i = 0; i < (int)in[0].size(); ++i) out[i] = valueNoise(in[0][i].d);
             };
+        t.emitCode = emitUnary("valueNoise(x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2019,6 +2337,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
         t.execute = [](const NodeData&, UserInput&, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
             for (int i = 0; i < (int)in[0].size(); ++i) out[i] = voronoiNoise(in[0][i].d);
             };
+        t.emitCode = emitUnary("voronoiNoise(x)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2034,6 +2353,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             int size = in[0].size();
             for (int i = 0; i < size; ++i) out[i] = perlinNoise(in[0][i].d, 6, 2.353, .5);
             };
+        t.emitCode = emitUnary("perlinNoise(x, 6, 2.353, .5)");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2063,6 +2383,18 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i] = perlinNoise(in[0][i].d, oct, lac, gain);
             }
         };
+        t.emitCode = emitFixed(R"(
+            int oct = i1[0].i;
+            oct = 12 < oct ? 12 : oct;
+            oct = 1 < oct ? oct : 1;
+            double lac = i2[0].d;
+            lac = 8.0 < lac ? 8.0 : lac;
+            lac = 1.0 < lac ? lac : 1.0;
+            double gain = i3[0].d;
+            gain = 1.0 < gain ? 1.0 : gain;
+            gain = 0.0 < gain ? gain : 0.0;
+            for (int k = 0; k < isize0; ++k) o[k].d = perlinNoise(i0[k].d, oct, lac, gain);
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2093,6 +2425,18 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 out[i] = ridgedMultiNoise(in[0][i].d, oct, lac);
             }
             };
+        t.emitCode = emitFixed(R"(
+            int64_t oct = i1[0].i;
+            oct = 12 < oct ? 12 : oct;
+            oct = 1 < oct ? oct : 1;
+            double lac = i2[0].d;
+            lac = 8.0 < lac ? 8.0 : lac;
+            lac = 1.0 < lac ? lac : 1.0;
+            double gain = i3[0].d;
+            gain = 1.0 < gain ? 1.0 : gain;
+            gain = 0.0 < gain ? gain : 0.0;
+            for (int k = 0; k < isize0; ++k) o[k].d = ridgedMultiNoise(i0[k].d, oct, lac);
+        )");
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2112,7 +2456,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 {
                     auto el = dynamic_cast<juce::TextEditor*>(comp.inputGUIElements.back().get());
                     node.setProperty("name", el->getText().toStdString());
-                    comp.getOwningScene()->onSceneChanged();
+                    comp.getOwningScene()->onSceneChanged(&node);
                 };
 
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
@@ -2133,17 +2477,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             //    u.namedValues.insert({ key, in[0][0].d });
             //}
         };
-        t.emitCode = [](NodeData& nd, int uniqueNodeOrder) {
-            return ("v" + juce::String(uniqueNodeOrder) + nd.getStringProperty("name") + " = i0[0].d;").toStdString();
+        t.emitCode = [](NodeData& nd, int) {
+            return namedValueVar(nd) + " = i0[0].d; o[0].d = i0[0].d;";
         };
-        t.globalVarNames = [](NodeData& nd, int uniqueNodeOrder) {
-            std::vector<GlobalClangVar> globVars;
-            GlobalClangVar var;
-            var.isStatic = true;
-            var.type = "double";
-            var.varName = ("v" + juce::String(uniqueNodeOrder) + nd.getStringProperty("name")).toStdString();
-            globVars.push_back(var);
-            return globVars;
+        t.globalVarNames = [](NodeData& nd, int) {
+            return std::vector<GlobalClangVar>{ { true, "double", namedValueVar(nd) } };
         };
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = false; t.fromScene = nullptr; registry.push_back(t);
     }
@@ -2163,7 +2501,7 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 {
                     auto el = dynamic_cast<juce::TextEditor*>(comp.inputGUIElements.back().get());
                     node.setProperty("name", el->getText().toStdString());
-                    comp.getOwningScene()->onSceneChanged();
+                    comp.getOwningScene()->onSceneChanged(&node);
                 };
 
             const float scale = (float)std::pow(2.0, comp.getOwningScene()->logScale);
@@ -2175,9 +2513,15 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             comp.addAndMakeVisible(back);
         };
         t.execute = [](const NodeData& node, UserInput& u, const std::vector<std::span<ddtype>>& in, std::span<ddtype> out, const RunnerInput&) {
-            auto key = node.getStringProperty("name");
+            //auto key = node.getStringProperty("name"); // copies the string, keep it off the audio thread
             //out[0].d = u.namedValues.contains(key) ? u.namedValues.at(key) : 0.0;
         };
+        t.emitCode = [](NodeData& nd, int) {
+            return "o[0].d = " + namedValueVar(nd) + ";";
+        };
+        t.globalVarNames = [](NodeData& nd, int) {
+            return std::vector<GlobalClangVar>{ { true, "double", namedValueVar(nd) } };
+        };
         t.outputType = InputType::decimal; t.alwaysOutputsRuntimeData = true; t.fromScene = nullptr; registry.push_back(t);
     }
 
@@ -2304,8 +2648,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                         comp.getWidth() - 2 * padding, lblH);
             };
 
+        webAudioInputType.emitCode = emitStoredAudio();
         webAudioInputType.outputType = InputType::decimal;
         webAudioInputType.alwaysOutputsRuntimeData = true; // outputs actual audio samples
+        webAudioInputType.isBlockRate = true;
         webAudioInputType.fromScene = nullptr;
 
         registry.push_back(webAudioInputType);
@@ -2336,8 +2682,10 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
             std::span<ddtype> output, const RunnerInput& inlineInstance)
             {
                 const auto& uvs = inputs[0];
-                const auto& vec = nd.optionalStoredAudio;
-                int n = static_cast<int>(vec.size());
+                // the plan hands over its live copy of the table as a last input, see NodeType::liveValues
+                const bool live = inputs.size() > 1;
+                const ddtype* vec = live ? inputs[1].data() : nd.optionalStoredAudio.data();
+                int n = static_cast<int>(live ? inputs[1].size() : nd.optionalStoredAudio.size());
                 if (n == 0) {
                     for (int i = 0; i < output.size(); i++) output[i] = 0.0;
                     return;
@@ -2365,7 +2713,13 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                     output[i] = v0 + frac * (v1 - v0);
                 }
             };
+        t.emitCode = [](NodeData& nd, int) {
+            const int n = (int)nd.optionalStoredAudio.size();
+            if (n == 0) return std::string("for (int k = 0; k < osize; ++k) o[k].d = 0.0;");
+            return "{ const ddtype* restrict vec = i1; const int n = isize1;" + emitResample("i0", "isize0") + " }";
+        };
         t.outputType = InputType::decimal;
+        t.liveValues = NodeType::LiveValues::table;
         t.alwaysOutputsRuntimeData = false;
         t.fromScene = nullptr;
         registry.push_back(t);
@@ -2415,6 +2769,12 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                     output[i] = v0 + frac * (v1 - v0);
                 }
             };
+        vectorResampleType.emitCode = emitFixed(R"(
+            const ddtype* restrict vec = i0;
+            const int n = isize0;
+            if (n == 0) { for (int k = 0; k < osize; ++k) o[k].d = 0.0; }
+            else {)" + emitResample("i1", "isize1") + R"(}
+        )");
         vectorResampleType.outputType = InputType::decimal;
         vectorResampleType.alwaysOutputsRuntimeData = false;
         vectorResampleType.fromScene = nullptr;
@@ -2452,6 +2812,11 @@ void WaviateFlow2025AudioProcessor::initializeRegistry()
                 }
             };
         t.whichInputToFollowWildcard = 0;
+        t.emitCode = emitFixed(R"(
+            int written = 0;
+            for (int k = 0; k < isize0; ++k) if (i0[k].i) o[written++].i = k;
+            for (; written < isize0; ++written) o[written].i = -1;
+        )");
         t.outputType = InputType::integer;
         t.alwaysOutputsRuntimeData = false;
         t.fromScene = nullptr;
@@ -88,6 +88,85 @@ inline double wrapTo(double v, double lo, double hi) {
 
 inline int64_t truthy(int64_t v) { return v != 0; }
 
+// emitCode building blocks. the C runs inside Runner::initializeClang's block for the step, which
+// declares o / osize for the output, iJ / isizeJ per input, u, stores and the n_<property> doubles
+using EmitFn = std::function<std::string(NodeData&, int)>;
+
+// the same C whatever the node's properties
+inline EmitFn emitFixed(const std::string& code) {
+    return [code](NodeData&, int) { return code; };
+}
+
+// o[k].d = expr for every element of i0, which expr sees as x
+inline EmitFn emitUnary(const std::string& expr) {
+    return emitFixed("for (int k = 0; k < isize0; ++k) { const double x = i0[k].d; o[k].d = " + expr + "; }");
+}
+
+// expr over a = i0[k].d and b = i1[k].d where both exist, the longer input's tail copied through
+inline std::string emitPadded(const std::string& expr) {
+    return "{ const int n = isize0 < isize1 ? isize0 : isize1;"
+        " for (int k = 0; k < n; ++k) { const double a = i0[k].d, b = i1[k].d; o[k].d = " + expr + "; }"
+        " for (int k = n; k < isize0; ++k) o[k] = i0[k];"
+        " for (int k = n; k < isize1; ++k) o[k] = i1[k]; }";
+}
+
+inline std::string emitTruncated(const std::string& expr) {
+    return "{ const int n = isize0 < isize1 ? isize0 : isize1;"
+        " for (int k = 0; k < n; ++k) { const double a = i0[k].d, b = i1[k].d; o[k].d = " + expr + "; } }";
+}
+
+inline std::string emitOuter(const std::string& expr) {
+    return "for (int r = 0; r < isize0; ++r) for (int c = 0; c < isize1; ++c)"
+        " { const double a = i0[r].d, b = i1[c].d; o[r * isize1 + c].d = " + expr + "; }";
+}
+
+// a binary op whose broadcasting follows the op_mode property. the mode is fixed per node, so the
+// kernel only gets the loop that applies
+inline EmitFn emitBinaryOp(const std::string& expr) {
+    return [expr](NodeData& nd, int) {
+        const int mode = (int)nd.getNumericProperty("op_mode");
+        return mode == 0 ? emitPadded(expr) : mode == 1 ? emitTruncated(expr) : mode == 2 ? emitOuter(expr) : std::string("(void)o;");
+    };
+}
+
+// o[k].i = expr over the truth values a and b, the shorter input padded with false
+inline EmitFn emitLogic(const std::string& expr) {
+    return emitFixed("{ const int n = isize0 > isize1 ? isize0 : isize1;"
+        " for (int k = 0; k < n; ++k) { const int a = k < isize0 && i0[k].i != 0, b = k < isize1 && i1[k].i != 0;"
+        " o[k].i = (" + expr + ") ? 1 : 0; } }");
+}
+
+// past, head, count and mask of the history of the channel being rendered, for CircleBuffer_get
+inline const std::string emitChannelHistory =
+    "const double* past = u->isStereoRight ? u->rightInputHistoryArray : u->leftInputHistoryArray;"
+    " const int head = u->isStereoRight ? u->rightInputHistoryHead : u->leftInputHistoryHead;"
+    " const int count = u->isStereoRight ? u->rightInputHistorySize : u->leftInputHistorySize;"
+    " const int mask = u->historyMask;";
+
+// linear lookup into vec[0, n) at the wrapped positions in uvs, custom curve and vector resample
+inline std::string emitResample(const std::string& uvs, const std::string& uvsSize) {
+    return " for (int k = 0; k < " + uvsSize + "; ++k) {"
+        " const double uv = " + uvs + "[k].d - floor(" + uvs + "[k].d);"
+        " const double scaled = uv * (n - 1);"
+        " int lower = (int)floor(scaled), upper = (int)ceil(scaled);"
+        " const double frac = scaled - lower;"
+        " lower = (lower % n + n) % n; upper = (upper % n + n) % n;"
+        " o[k].d = vec[lower].d + frac * (vec[upper].d - vec[lower].d); }";
+}
+
+// the kernel-wide variable behind set / get named value, by name so every node naming it shares it
+inline std::string namedValueVar(NodeData& nd) {
+    return sanitizeIdentifier("nv_" + nd.getStringProperty("name"));
+}
+
+// the node's stored data as is, cut to the output (audio file, web audio)
+inline EmitFn emitStoredAudio() {
+    return [](NodeData& nd, int) {
+        if (nd.optionalStoredAudio.empty()) return std::string("if (osize > 0) o[0].d = 0.0;");
+        return "for (int k = 0; k < osize && k < " + std::to_string(nd.optionalStoredAudio.size()) + "; ++k) o[k] = stores[k];";
+    };
+}
+
 using Comparator = bool (*)(double, double);
 template <Comparator cmp>
 inline void cmpExec(const NodeData&,
@@ -107,8 +186,9 @@ inline void cmpExec(const NodeData&,
     }
 }
 
+// cExpr is cmp again as a C expression over a and b, for the JIT
 template<Comparator cmp>
-inline void makeCmp(uint16_t id, const char* nm, const char* tip, std::vector<NodeType>& registry)
+inline void makeCmp(uint16_t id, const char* nm, const char* tip, const char* cExpr, std::vector<NodeType>& registry)
 {
     NodeType t(id);
     t.name = nm;
@@ -120,6 +200,9 @@ inline void makeCmp(uint16_t id, const char* nm, const char* tip, std::vector<No
     t.buildUI = [](NodeComponent&, NodeData&) {};
     t.onResized = [](NodeComponent&) {};
     t.execute = &cmpExec<cmp>;   // <-- function pointer, no std::function
+    t.emitCode = emitFixed(std::string("{ const int n = isize0 > isize1 ? isize0 : isize1;"
+        " for (int k = 0; k < n; ++k) { const double a = k < isize0 ? i0[k].d : 0.0, b = k < isize1 ? i1[k].d : 0.0;"
+        " o[k].i = (") + cExpr + ") ? 1 : 0; } }");
     t.outputType = InputType::boolean;
     t.alwaysOutputsRuntimeData = false;
     t.fromScene = nullptr;
@@ -8,7 +8,9 @@
   ==============================================================================
 */
 #define NOMINMAX
+#if !WAVIATE_JIT // see Runner.h
 #define USE_GRAPH_EXEC
+#endif
 #define USE_EMBEDDED_CLANG
 #include <JuceHeader.h>
 #ifdef _WIN32
@@ -18,8 +20,12 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <set>
+#include <algorithm>
 
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/Support/TargetSelect.h>
 #include <clang/CodeGen/CodeGenAction.h>
@@ -55,6 +61,12 @@ std::string triple = "x86_64-unknown-linux-gnu";
 #include "PluginProcessor.h"
 #include <format>
 #include "NodeType.h"
+#include "RealtimeCheck.h"
+#include "GraphOptimizer.h"
+#include "KernelCache.h"
+#include "BranchPool.h"
+#include "Noise.h"
+#include "Envelope.h"
 
 
 void Runner::setupIterative(NodeData* root, RunnerInput& inlineInstance) {
@@ -251,6 +263,42 @@ NodeFn compileNodeKernel(const std::string& sourceCode,
 		initialized = true;
 	}
 
+	// --- 0. Already built, in this session or an earlier one
+	if (!GlobalJIT) {
+		GlobalJIT = cantFail(LLJITBuilder()
+			.setCompileFunctionCreator([](JITTargetMachineBuilder JTMB)
+				-> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+				return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB), &KernelCache::get());
+			})
+			.create());
+
+		// what kernels call back into, declared on their side by NoiseClang
+		SymbolMap helpers;
+		auto bind = [&helpers](const char* name, auto* fn) {
+			helpers[GlobalJIT->mangleAndIntern(name)] = { ExecutorAddr::fromPtr(fn), JITSymbolFlags::Exported | JITSymbolFlags::Callable };
+		};
+		bind("uniform_closed", &uniform_closed);
+		bind("deterministic_uniform_closed", &deterministic_uniform_closed);
+		bind("coin_flip", &coin_flip);
+		bind("valueNoise", &valueNoise);
+		bind("voronoiNoise", &voronoiNoise);
+		bind("perlinNoise", &perlinNoise);
+		bind("ridgedMultiNoise", &ridgedMultiNoise);
+		cantFail(GlobalJIT->getMainJITDylib().define(absoluteSymbols(std::move(helpers))));
+	}
+	if (auto sym = GlobalJIT->lookup(funcName)) {
+		return sym->toPtr<NodeFn>();
+	}
+	else {
+		consumeError(sym.takeError());
+	}
+	const std::string cacheKey = KernelCache::keyFor(sourceCode,
+		triple + " O" + std::to_string(OX.getSpeedupLevel()) + "s" + std::to_string(OX.getSizeLevel()));
+	if (auto object = KernelCache::get().load(cacheKey)) {
+		cantFail(GlobalJIT->addObjectFile(std::move(object)));
+		return cantFail(GlobalJIT->lookup(funcName)).toPtr<NodeFn>();
+	}
+
 	// --- 1. Single LLVM context
 	auto TSCtx = std::make_unique<LLVMContext>();
 	LLVMContext* Ctx = TSCtx.get();
@@ -313,16 +361,12 @@ NodeFn compileNodeKernel(const std::string& sourceCode,
 	llvm::ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(OX);
 	MPM.run(*M, MAM);
 
-	// --- 8. Initialize the JIT if needed
-	if (!GlobalJIT) {
-		GlobalJIT = cantFail(LLJITBuilder().create());
-	}
-
-	// --- 9. Hand module to ORC
+	// --- 8. Hand module to ORC, KernelCache keeps the object it compiles to
+	M->setModuleIdentifier(cacheKey);
 	orc::ThreadSafeModule TSM(std::move(M), std::move(TSCtx));
 	cantFail(GlobalJIT->addIRModule(std::move(TSM)));
 
-	// --- 10. Lookup symbol
+	// --- 9. Lookup symbol
 	auto sym = cantFail(GlobalJIT->lookup(funcName));
 	return sym.toPtr<NodeFn>();
 }
@@ -330,7 +374,29 @@ NodeFn compileNodeKernel(const std::string& sourceCode,
 
 
 
-uint64_t globalCompileCounter;
+NodeFn Runner::compileKernel(const std::string& sourceCode, const std::string& funcName, OptLevel optLevel)
+{
+#ifdef USE_GRAPH_EXEC
+	juce::ignoreUnused(sourceCode, funcName, optLevel);
+	return nullptr; // interpreted plan only
+#else
+	llvm::OptimizationLevel OX;
+	switch (optLevel) {
+	case OptLevel::high:           OX = llvm::OptimizationLevel::O3; break;
+	case OptLevel::medium:         OX = llvm::OptimizationLevel::O2; break;
+	case OptLevel::low:            OX = llvm::OptimizationLevel::O1; break;
+	case OptLevel::minimal:        OX = llvm::OptimizationLevel::O0; break;
+	case OptLevel::prioritizeSize: OX = llvm::OptimizationLevel::Oz; break;
+	case OptLevel::tradeOffSize:   OX = llvm::OptimizationLevel::Os; break;
+	}
+#ifdef USE_EMBEDDED_CLANG
+	return compileNodeKernel(sourceCode, funcName, OX);
+#else 
+	return compileNodeKernelDll(sourceCode, funcName, optLevel);
+		//,OX);
+#endif
+#endif
+}
 
 void Runner::setupRecursive(NodeData* node, RunnerInput& inlineInstance) {
 	
@@ -351,105 +417,321 @@ void Runner::setupRecursive(NodeData* node, RunnerInput& inlineInstance) {
 	inlineInstance.nodesOrder.push_back(node);
 }
 
-inline void convert(const std::span<ddtype>& data, InputType outboundType, InputType inboundType) {
+// writes into its own slot, the producer's buffer is left alone for its other consumers
+inline void convert(std::span<const ddtype> from, std::span<ddtype> to, InputType outboundType, InputType inboundType) {
+	const size_t n = std::min(from.size(), to.size());
 	if (outboundType == InputType::decimal) {
 		if (inboundType == InputType::boolean) {
-			for (ddtype& d : data) { d.i = d.d > 0.5 ? 1 : 0; }
+			for (size_t k = 0; k < n; ++k) { to[k].i = from[k].d > 0.5 ? 1 : 0; }
 		}
-		else if (inboundType == InputType::integer) {
-			for (ddtype& d : data) { d.i = static_cast<int64_t>(std::round(d.d)); }
+		else {
+			for (size_t k = 0; k < n; ++k) { to[k].i = static_cast<int64_t>(std::round(from[k].d)); }
 		}
 	}
 	else if (outboundType == InputType::integer) {
 		if (inboundType == InputType::boolean) {
-			for (ddtype& d : data) { d.i = (d.i == 0 ? 0 : 1); }
+			for (size_t k = 0; k < n; ++k) { to[k].i = (from[k].i == 0 ? 0 : 1); }
 		}
-		else if (inboundType == InputType::decimal) {
-			for (ddtype& d : data) { d.d = static_cast<double>(d.i); }
+		else {
+			for (size_t k = 0; k < n; ++k) { to[k].d = static_cast<double>(from[k].i); }
 		}
 	}
-	else if (inboundType == InputType::decimal) {
-		for (ddtype& d : data) { d.d = d.i ? 1.0 : 0.0; }
+	else {
+		for (size_t k = 0; k < n; ++k) { to[k].d = from[k].i ? 1.0 : 0.0; }
 	}
 }
 
-std::span<ddtype> Runner::runClang(RunnerInput* runnerInputP, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs)
+// boolean is stored as 0/1 in .i, so it already is a valid integer. unresolved types pass through as before
+static bool needsConversion(InputType outboundType, InputType inboundType) {
+	auto concrete = [](InputType t) { return t == InputType::decimal || t == InputType::boolean || t == InputType::integer; };
+	return concrete(outboundType) && concrete(inboundType) && outboundType != inboundType
+		&& !(outboundType == InputType::boolean && inboundType == InputType::integer);
+}
+
+// group picks the same slice of the plan runBlockRate (0), runSampleRate (1) and runChannel (2) would
+// have walked. the kernel writes field exactly like the plan does, so either can take over mid-stream
+std::span<ddtype> Runner::runClang(const RunnerInput* runnerInputP, int group, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs)
 {
-	int outputSize = runnerInputP->outputNode->getCompileTimeSize(runnerInputP);
-	std::vector<ddtype> result;
-	result.resize(outputSize);
+	REALTIME_SITE();
+	auto& inputPtrs = runnerInputP->clangInputPtrs;
+	auto& inputSizes = runnerInputP->clangInputSizes;
+
+	// scratch is sized by initialize, one slot per input node of the scene
+	jassert(outerInputs.size() <= inputPtrs.size());
+	const int numInputs = (int)std::min(outerInputs.size(), inputPtrs.size());
+	for (int i = 0; i < numInputs; ++i) {
+		inputPtrs[i] = outerInputs[i].data();               // pointer to ddtype
+		inputSizes[i] = static_cast<int>(outerInputs[i].size()); // length
+	}
 
-	std::vector<ddtype*> inputPtrs;
-	std::vector<int> inputSizes;
+	NodeFn kernel = runnerInputP->compiledFunc.load(std::memory_order_acquire);
+	if (!kernel) return std::span<ddtype>();
+	auto output = runnerInputP->outputSpan;
+	kernel(const_cast<ddtype*>(runnerInputP->field.data()), (int)runnerInputP->field.size(), output.data(), (int)output.size(),
+		inputPtrs.data(), inputSizes.data(), numInputs, &userInput, group);
 
-	inputPtrs.reserve(outerInputs.size());
-	inputSizes.reserve(outerInputs.size());
+	return output;
+}
 
-	for (const auto& sp : outerInputs) {
-		inputPtrs.push_back(sp.data());               // pointer to ddtype
-		inputSizes.push_back(static_cast<int>(sp.size())); // length
+// the node once per active lane, on one-element views of its buffers (PlanStep::lanes)
+static void runActiveLanes(const RunnerInput& runnerInput, const PlanStep& step, UserInput& userInput)
+{
+	double sum = 0.0;
+	ddtype laneOutput;
+	for (int a = 0; a < userInput.numActiveLanes; ++a) {
+		const int lane = userInput.activeLanes[a];
+		for (int j = 0; j < step.numInputs; ++j) step.laneInputs[j] = step.inputs[j].subspan(lane, 1);
+		std::span<ddtype> output = step.lanes == LaneMode::sum ? std::span<ddtype>(&laneOutput, 1) : step.output.subspan(lane, 1);
+		step.execute(*step.node, userInput, step.laneInputs, output, runnerInput);
+		sum += output[0].d;
 	}
+	if (step.lanes == LaneMode::sum) step.output[0].d = sum;
+}
 
-	runnerInputP->compiledFunc(runnerInputP->field.data(), runnerInputP->field.size(), result.data(), outputSize, inputPtrs.data(), inputSizes.data(), static_cast<int>(inputPtrs.size()), &userInput);
+// steps and conversions are the plan's, or the pipeline front's copies of them
+static void runSteps(const RunnerInput& runnerInput, const PlanStep* steps, const PlanConversion* conversions,
+	size_t begin, size_t end, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs)
+{
+	for (size_t s = begin; s < end; ++s)
+	{
+		const PlanStep& step = steps[s];
+		REALTIME_SITE_NAMED(step.node->getType()->name.toRawUTF8());
+		for (int c = 0; c < step.numConversions; ++c) {
+			const PlanConversion& conv = conversions[step.firstConversion + c];
+			convert(conv.source, conv.dest, conv.outboundType, conv.inboundType);
+		}
+		if (!step.outerDefault.empty()) {
+			const int inputIndex = step.outerInputIndex;
+			step.inputs.back() = (inputIndex >= 0 && inputIndex < (int)outerInputs.size()) ? outerInputs[inputIndex] : step.outerDefault;
+		}
+		if (step.lanes == LaneMode::each || step.lanes == LaneMode::sum) runActiveLanes(runnerInput, step, userInput);
+		else step.execute(*step.node, userInput, step.inputs, step.output, runnerInput);
+	}
+}
 
-	return std::span<ddtype>(result);
+static void runSteps(const RunnerInput& runnerInput, size_t begin, size_t end, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs)
+{
+	runSteps(runnerInput, runnerInput.plan.data(), runnerInput.planConversions.data(), begin, end, userInput, outerInputs);
 }
 
+static const std::vector<std::span<ddtype>> noOuterInputs;
+
 std::span<ddtype> Runner::run(const RunnerInput* runnerInputP, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs)
+{
+	if (!runnerInputP) return std::span<ddtype, 0>();
+	auto& runnerInput = *runnerInputP;
+	if (runnerInput.plan.empty()) return std::span<ddtype, 0>(); // instances own no nodes, see instantiate
+	if (runnerInput.compiledFunc.load(std::memory_order_acquire)) {
+		runClang(runnerInputP, 0, userInput, outerInputs);
+		runClang(runnerInputP, 1, userInput, outerInputs);
+		return runClang(runnerInputP, 2, userInput, outerInputs);
+	}
+	REALTIME_SITE();
+	runSteps(runnerInput, 0, runnerInput.plan.size(), userInput, outerInputs);
+	return runnerInput.outputSpan;
+}
+
+void Runner::runBlockRate(const RunnerInput* runnerInputP, UserInput& userInput)
+{
+	if (!runnerInputP || runnerInputP->nodeCopies.empty()) return;
+	if (runnerInputP->compiledFunc.load(std::memory_order_acquire)) {
+		runClang(runnerInputP, 0, userInput, noOuterInputs);
+		return;
+	}
+	REALTIME_SITE();
+	runSteps(*runnerInputP, 0, runnerInputP->firstSampleRateStep, userInput, noOuterInputs);
+}
+
+struct FrameJob {
+	const RunnerInput* runner;
+	UserInput* userInput;
+	bool compiled;
+};
+
+// one task of the frame on whichever thread of the pool claimed it. the kernel has a case per task too
+static void runFrameTask(void* context, int task)
+{
+	const FrameJob& job = *static_cast<const FrameJob*>(context);
+	if (job.compiled) {
+		Runner::runClang(job.runner, 3 + task, *job.userInput, noOuterInputs);
+		return;
+	}
+	const auto& tasks = job.runner->frameTasks;
+	runSteps(*job.runner, tasks[task], tasks[task + 1], *job.userInput, noOuterInputs);
+}
+
+void Runner::runSampleRate(const RunnerInput* runnerInputP, UserInput& userInput, BranchPool* pool)
+{
+	if (!runnerInputP || runnerInputP->nodeCopies.empty()) return;
+	const auto& tasks = runnerInputP->frameTasks;
+	if (pool && pool->getNumWorkers() > 0 && !tasks.empty()) {
+		REALTIME_SITE();
+		const int numTasks = (int)tasks.size() - 1;
+		FrameJob job{ runnerInputP, &userInput, runnerInputP->compiledFunc.load(std::memory_order_acquire) != nullptr };
+		pool->run(&runFrameTask, &job, numTasks);
+		// then what joins the branches, on this thread
+		if (job.compiled) runClang(runnerInputP, 3 + numTasks, userInput, noOuterInputs);
+		else runSteps(*runnerInputP, tasks.back(), runnerInputP->firstChannelStep, userInput, noOuterInputs);
+		return;
+	}
+	if (runnerInputP->compiledFunc.load(std::memory_order_acquire)) {
+		runClang(runnerInputP, 1, userInput, noOuterInputs);
+		return;
+	}
+	REALTIME_SITE();
+	runSteps(*runnerInputP, runnerInputP->firstSampleRateStep, runnerInputP->firstChannelStep, userInput, noOuterInputs);
+}
+
+std::span<ddtype> Runner::runChannel(const RunnerInput* runnerInputP, UserInput& userInput)
 {
 	if (!runnerInputP) return std::span<ddtype, 0>();
 	auto& runnerInput = *runnerInputP;
 	if (runnerInput.nodeCopies.empty()) return std::span<ddtype, 0>();
-	for (NodeData* node : runnerInput.nodesOrder)
-	{
-		auto& output = runnerInput.nodeOwnership.at(node);
-		std::vector<std::span<ddtype>> inputs;
-		std::vector<ddtype> emptyInputDefaults(node->getNumInputs());
-		for (int i = 0; i < node->getNumInputs(); i += 1) {
-			if (auto inputNode = node->getInput(i)) {
-				auto& otherspan = runnerInput.nodeOwnership.at(inputNode);
-				auto outboundType = inputNode->getType()->outputType;
-				auto inboundType = node->getType()->inputs[i].inputType;
-				if (outboundType == InputType::followsInput) {
-					outboundType = inputNode->getTrueType();
-				}
-				if (inboundType == InputType::any) {
-					inboundType = node->getTrueType();
-				}
-				convert(otherspan, outboundType, inboundType);
-				inputs.push_back(otherspan);
-			}
-			else {
-				emptyInputDefaults[i] = node->defaultValues[i];
-				std::span<ddtype> otherspan(&emptyInputDefaults[i], 1);
-				inputs.push_back(otherspan);
-			}
-		}
-		ddtype defaultIfNeeded = 0.0;
-		
-		
-		if (node->getType()->isInputNode) {
-			int inputIndex = node->inputIndex;
-			if (inputIndex >= 0 && inputIndex < outerInputs.size()) {
-				inputs.push_back(outerInputs[inputIndex]);
-			}
-			else {
-				if (node->getType()->outputType == InputType::decimal) {
-					defaultIfNeeded.d = node->getNumericProperties().contains("defaultValue") ? node->getNumericProperty("defaultValue") : 0.0;
-				}
-				else if (node->getType()->outputType == InputType::boolean) {
-					defaultIfNeeded.i = node->getNumericProperties().contains("defaultValue") ? (node->getNumericProperty("defaultValue") > 0.5 ? 1 : 0) : 0;
-				}
-				else {
-					defaultIfNeeded.i = node->getNumericProperties().contains("defaultValue") ? static_cast<int>(std::round(node->getNumericProperty("defaultValue"))) : 0;
-				}
-				std::span<ddtype> spanOverDefaultIfNeeded(&defaultIfNeeded, 1);
-				inputs.push_back(spanOverDefaultIfNeeded);
-			}
-		}
-		node->getType()->execute(*node, userInput, inputs, output, runnerInput);
+	if (runnerInput.compiledFunc.load(std::memory_order_acquire)) {
+		// swapped in by RunnerCompiler
+		return runClang(runnerInputP, 2, userInput, noOuterInputs);
 	}
-	return runnerInput.nodeOwnership.at(runnerInput.outputNode);
+	REALTIME_SITE();
+	runSteps(runnerInput, runnerInput.firstChannelStep, runnerInput.plan.size(), userInput, noOuterInputs);
+	return runnerInput.outputSpan;
+}
+
+// the kernel over the pipeline front's field. false when there's no kernel yet
+static bool runFrontKernel(const RunnerInput& runner, int group, UserInput& userInput)
+{
+	NodeFn kernel = runner.compiledFunc.load(std::memory_order_acquire);
+	if (!kernel) return false;
+	ddtype* field = const_cast<ddtype*>(runner.pipelineField.data());
+	ddtype* output = field + (runner.outputSpan.data() - runner.field.data());
+	kernel(field, (int)runner.pipelineField.size(), output, (int)runner.outputSpan.size(),
+		runner.clangInputPtrs.data(), runner.clangInputSizes.data(), 0, &userInput, group);
+	return true;
+}
+
+void Runner::runBlockRateFront(const RunnerInput* runnerInputP, UserInput& userInput)
+{
+	if (!runnerInputP || runnerInputP->pipelineCut < 0) return;
+	REALTIME_SITE();
+	const RunnerInput& runner = *runnerInputP;
+	if (runFrontKernel(runner, 0, userInput)) return;
+	runSteps(runner, runner.pipelinePlan.data(), runner.pipelineConversions.data(), 0, runner.firstSampleRateStep, userInput, noOuterInputs);
+}
+
+void Runner::runSampleRateFront(const RunnerInput* runnerInputP, UserInput& userInput, std::span<ddtype> boundary)
+{
+	if (!runnerInputP || runnerInputP->pipelineCut < 0) return;
+	REALTIME_SITE();
+	const RunnerInput& runner = *runnerInputP;
+	jassert(boundary.size() >= (size_t)runner.pipelineBoundarySize);
+	if (!runFrontKernel(runner, -1, userInput)) {
+		runSteps(runner, runner.pipelinePlan.data(), runner.pipelineConversions.data(), runner.firstSampleRateStep, runner.pipelineCut, userInput, noOuterInputs);
+	}
+	ddtype* to = boundary.data();
+	for (auto [offset, size] : runner.pipelineBoundary) {
+		to = std::copy_n(runner.pipelineField.data() + offset, size, to);
+	}
+}
+
+void Runner::runSampleRateBack(const RunnerInput* runnerInputP, UserInput& userInput, std::span<const ddtype> boundary)
+{
+	if (!runnerInputP || runnerInputP->nodeCopies.empty()) return;
+	const RunnerInput& runner = *runnerInputP;
+	if (runner.pipelineCut < 0) {
+		runSampleRate(runnerInputP, userInput);
+		return;
+	}
+	REALTIME_SITE();
+	ddtype* field = const_cast<ddtype*>(runner.field.data());
+	const ddtype* from = boundary.data();
+	for (auto [offset, size] : runner.pipelineBoundary) {
+		std::copy_n(from, size, field + offset);
+		from += size;
+	}
+	if (runner.compiledFunc.load(std::memory_order_acquire)) {
+		runClang(runnerInputP, -2, userInput, noOuterInputs);
+		return;
+	}
+	runSteps(runner, runner.pipelineCut, runner.firstChannelStep, userInput, noOuterInputs);
+}
+
+std::span<ddtype> Runner::runVoice(const RunnerInput* runnerInputP, int voice, int group)
+{
+	if (!runnerInputP || voice < 0 || voice >= (int)runnerInputP->voices.size()) return std::span<ddtype, 0>();
+	REALTIME_SITE();
+	const RunnerInput& runner = *runnerInputP;
+	const VoiceState& state = runner.voices[voice];
+	ddtype* field = const_cast<ddtype*>(state.field.data());
+	std::span<ddtype> output(field + (runner.outputSpan.data() - runner.field.data()), runner.outputSpan.size());
+	if (NodeFn kernel = runner.compiledFunc.load(std::memory_order_acquire)) {
+		kernel(field, (int)state.field.size(), output.data(), (int)output.size(),
+			runner.clangInputPtrs.data(), runner.clangInputSizes.data(), 0, state.input.get(), group);
+		return output;
+	}
+	const int begin = group == 0 ? 0 : group == 1 ? runner.firstSampleRateStep : runner.firstChannelStep;
+	const int end = group == 0 ? runner.firstSampleRateStep : group == 1 ? runner.firstChannelStep : (int)state.plan.size();
+	runSteps(runner, state.plan.data(), state.conversions.data(), begin, end, *state.input, noOuterInputs);
+	return output;
+}
+
+void Runner::resetVoice(const RunnerInput* runnerInputP, int voice)
+{
+	if (!runnerInputP || voice < 0 || voice >= (int)runnerInputP->voices.size()) return;
+	REALTIME_SITE();
+	const RunnerInput& runner = *runnerInputP;
+	std::copy(runner.voiceField.begin(), runner.voiceField.end(), const_cast<ddtype*>(runner.voices[voice].field.data()));
+}
+
+void Runner::setLiveValue(RunnerInput* runner, const NodeData* node, int index, ddtype value)
+{
+	if (!runner) return;
+	REALTIME_SITE();
+	auto [first, last] = runner->liveSlots.equal_range(node);
+	for (; first != last; ++first) {
+		auto [offset, size] = first->second;
+		if (index >= size) continue;
+		runner->field[offset + index] = value;
+		if (!runner->pipelineField.empty()) runner->pipelineField[offset + index] = value;
+		if (!runner->voiceField.empty()) runner->voiceField[offset + index] = value;
+		for (VoiceState& voice : runner->voices) voice.field[offset + index] = value;
+	}
+	for (auto& [custom, sub] : runner->subRunners) setLiveValue(sub.get(), node, index, value);
+}
+
+bool Runner::getLiveValue(const RunnerInput* runner, const NodeData* node, int index, ddtype& value)
+{
+	if (!runner) return false;
+	auto [first, last] = runner->liveSlots.equal_range(node);
+	for (; first != last; ++first) {
+		auto [offset, size] = first->second;
+		if (index >= size) continue;
+		value = runner->field[offset + index];
+		return true;
+	}
+	for (auto& [custom, sub] : runner->subRunners) {
+		if (getLiveValue(sub.get(), node, index, value)) return true;
+	}
+	return false;
+}
+
+// a custom node in the sub-plan that wasn't inlined and didn't get an instance plays nothing, any
+// slots it would have don't matter
+static bool liveSlotsFit(const RunnerInput& runner, const NodeData* node, int size, bool& found)
+{
+	auto [first, last] = runner.liveSlots.equal_range(node);
+	for (; first != last; ++first) {
+		if (first->second.second != size) return false;
+		found = true;
+	}
+	for (auto& [custom, sub] : runner.subRunners) {
+		if (!liveSlotsFit(*sub, node, size, found)) return false;
+	}
+	return true;
+}
+
+bool Runner::hasLiveSlots(const RunnerInput& runner, const NodeData* node, int size)
+{
+	bool found = false;
+	return liveSlotsFit(runner, node, size, found) && found;
 }
 
 
@@ -463,7 +745,26 @@ bool Runner::containsNodeField(NodeData* d, std::unordered_map<NodeData*, std::s
 	return nodeOwnership.contains(d);
 }
 
-		
+
+// what an input node outputs when nothing is plugged into it from the enclosing scene
+static ddtype inputNodeDefault(const NodeData& node) {
+	// spliced in by inlineSubScenes: the custom node it came from left the input unconnected, its
+	// default for it rides after the input node's own (empty) defaults
+	if (node.defaultValues.size() > (size_t)node.getNumInputs()) return node.defaultValues.back();
+	ddtype value = 0.0;
+	const bool hasDefault = node.getNumericProperties().contains("defaultValue");
+	if (node.getType()->outputType == InputType::decimal) {
+		value.d = hasDefault ? node.getNumericProperty("defaultValue") : 0.0;
+	}
+	else if (node.getType()->outputType == InputType::boolean) {
+		value.i = hasDefault ? (node.getNumericProperty("defaultValue") > 0.5 ? 1 : 0) : 0;
+	}
+	else {
+		value.i = hasDefault ? static_cast<int>(std::round(node.getNumericProperty("defaultValue"))) : 0;
+	}
+	return value;
+}
+
 std::vector<ddtype> Runner::findRemainingSizes(
 	NodeData* root,
 	RunnerInput& inlineInstance,
@@ -523,8 +824,8 @@ std::vector<ddtype> Runner::findRemainingSizes(
 
 			if (node->getType()->isInputNode) {
 				int inputIndex = node->inputIndex;
-				if (outerInputs.empty()) {
-					inputspans.push_back({ 0.0 }); // TODO: custom defaults
+				if (inputIndex < 0 || inputIndex >= (int)outerInputs.size()) {
+					inputspans.push_back({ inputNodeDefault(*node) });
 				}
 				else {
 					inputspans.push_back(std::vector<ddtype>(
@@ -587,244 +888,1143 @@ void storeCopies(RunnerInput& input,
 		}
 
 
-	// cleanup / fix references
+	// cleanup / fix references. only the copies are written: the scene's own nodes may be read by
+	// another compile at the same time, one embedding this scene (see SceneData::compileLock). the
+	// edges were checked when they were made in the editor, the copies take them over as they are
 	for (auto& nodeCopy : input.nodeCopies) {
 		if (!nodeCopy) continue;
 
 		// fix inputs
 		for (int i = 0; i < nodeCopy->getNumInputs(); i++) {
-			if (auto in = nodeCopy->getInput(i)) {
-				if (!in->isCopy) {
-					auto it = remap.find(in);
-					if (it != remap.end()) {
-						nodeCopy->detachInput(i, nullptr);
-						nodeCopy->attachInput(i, it->second, input, nullptr);
-					}
-				}
+			NodeData* in = nodeCopy->getInput(i);
+			if (in && !in->isCopy) {
+				auto it = remap.find(in);
+				if (it != remap.end()) nodeCopy->inputNodes[i] = it->second;
 			}
 		}
 
 		// fix outputs
+		std::set<std::tuple<NodeData*, int>> outputs;
 		for (const auto& [output, idx] : nodeCopy->outputs) {
-			if (output && !output->isCopy) {
-				auto it = remap.find(output);
-				if (it != remap.end()) {
-					it->second->attachInput(idx, nodeCopy.get(), input, nullptr);
-				}
-			}
+			auto it = output && !output->isCopy ? remap.find(output) : remap.end();
+			outputs.insert({ it != remap.end() ? it->second : output, idx });
 		}
+		nodeCopy->outputs = std::move(outputs);
 	}
 }
 
-// Sanitizer for numeric values (ensures finite literal, not NaN/inf)
-inline std::string emitNumericLiteral(double d) {
-	if (!std::isfinite(d)) {
-		return "0.0"; // fallback
+
+
+// what a kernel can't reasonably carry as a literal array, the node stays interpreted instead
+constexpr size_t maxInlineStores = 1 << 16;
+
+static std::string emitStringLiteral(const std::string& s) {
+	std::string out = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') out.push_back('\\');
+		if (c == '\n' || c == '\r') continue;
+		out.push_back(c);
 	}
-	char buf[64];
-	std::snprintf(buf, sizeof(buf), "%.17g", d); // precise, portable C99 literal
-	return buf;
+	return out + "\"";
 }
 
-// Sanitizer for string values (UI ensures, but double safety here)
-inline std::string sanitizeIdentifier(const std::string& s) {
-	std::string out;
-	out.reserve(s.size());
-	for (char c : s) {
-		if ((c >= 'a' && c <= 'z') ||
-			(c >= 'A' && c <= 'Z') ||
-			(c >= '0' && c <= '9') ||
-			c == '_') {
-			out.push_back(c);
-		}
+// copies a producer's output into the consumer's type, same rules as convert()
+static std::string emitConversion(const PlanConversion& conv) {
+	std::string expr;
+	if (conv.outboundType == InputType::decimal) {
+		expr = conv.inboundType == InputType::boolean ? "to[k].i = from[k].d > 0.5;" : "to[k].i = (int64_t)round(from[k].d);";
+	}
+	else if (conv.outboundType == InputType::integer) {
+		expr = conv.inboundType == InputType::boolean ? "to[k].i = from[k].i != 0;" : "to[k].d = (double)from[k].i;";
 	}
-	if (out.empty() || std::isdigit(out[0])) {
-		out = "_" + out; // must be valid identifier
+	else {
+		expr = "to[k].d = from[k].i ? 1.0 : 0.0;";
 	}
-	return out;
+	return "  { const ddtype* restrict from = dataField + " + std::to_string(conv.sourceOffset)
+		+ "; ddtype* restrict to = dataField + " + std::to_string(conv.offset)
+		+ "; for (int k = 0; k < " + std::to_string(conv.size) + "; ++k) " + expr + " }\n";
 }
 
-
+// one block per plan step, over the field layout packField settled on. every buffer a step touches
+// gets its own restrict pointer: packField never hands a step an output that aliases one of its inputs
+static std::string emitStep(const RunnerInput& input, const PlanStep& step, int order) {
+	NodeData* nd = step.node;
+	auto type = nd->getType();
+	// GraphOptimizer's rewrites have their own C, anything else (specialized or not) goes by emitCode,
+	// which reads the node's settings at emit time anyway
+	std::string body = GraphOptimizer::emitKernel(step.execute);
+	if (body.empty()) body = step.lanes == LaneMode::active ? type->emitActiveLanes(*nd, order) : type->emitCode(*nd, order);
+	if (body.empty()) return ""; // no C, the plan stays interpreted
+	const bool bakesStores = type->liveValues != NodeType::LiveValues::table; // live tables are an input
+	if (bakesStores && nd->optionalStoredAudio.size() > maxInlineStores) return "";
+
+	std::string code;
+	for (int c = 0; c < step.numConversions; ++c) {
+		code += emitConversion(input.planConversions[step.firstConversion + c]);
+	}
+	// each and sum run the body once per active lane, over one-element views (see runActiveLanes)
+	const bool perLane = step.lanes == LaneMode::each || step.lanes == LaneMode::sum;
+	const std::string lane = perLane ? " + lane" : "";
+	code += "  {\n";
+	if (perLane) {
+		code += "  double laneSum = 0.0;\n";
+		code += "  for (int lanePos = 0; lanePos < u->numActiveLanes; ++lanePos) {\n";
+		code += "  const int lane = u->activeLanes[lanePos];\n";
+	}
+	if (step.lanes == LaneMode::sum) {
+		code += "  ddtype laneOutput[1];\n";
+		code += "  ddtype* restrict o = laneOutput;\n";
+	}
+	else {
+		code += "  ddtype* restrict o = dataField + " + std::to_string(step.outputOffset) + lane + ";\n";
+	}
+	code += "  const int osize = " + std::to_string(perLane ? 1 : step.outputSize) + ";\n";
+	for (int j = 0; j < step.numInputs; ++j) {
+		const PlanInput& in = input.planInputs[step.firstInput + j];
+		const std::string J = std::to_string(j);
+		const bool last = j == step.numInputs - 1;
+		if (last && step.fusedOutput) {
+			code += "  ddtype* restrict p = dataField + " + std::to_string(in.offset) + ";\n";
+		}
+		else if (j == step.stateInput) {
+			code += "  ddtype* restrict st = dataField + " + std::to_string(in.offset) + ";\n";
+		}
+		else if (last && step.outerInputIndex >= 0) {
+			// the caller's input when it passed one, the node's default otherwise
+			const std::string pin = std::to_string(step.outerInputIndex);
+			code += "  const ddtype* restrict i" + J + " = " + pin + " < numInputs ? inputs[" + pin + "] : dataField + " + std::to_string(in.offset) + ";\n";
+			code += "  const int isize" + J + " = " + pin + " < numInputs ? inputSizes[" + pin + "] : 1;\n";
+		}
+		else {
+			code += "  const ddtype* restrict i" + J + " = dataField + " + std::to_string(in.offset) + lane + ";\n";
+			code += "  const int isize" + J + " = " + std::to_string(perLane ? 1 : in.size) + ";\n";
+		}
+	}
+	for (auto& [k, v] : nd->getNumericProperties()) {
+		code += "  const double n_" + sanitizeIdentifier(k) + " = " + emitNumericLiteral(v) + ";\n";
+	}
+	for (auto& [k, v] : nd->getProperties()) {
+		code += "  static const char s_" + sanitizeIdentifier(k) + "[] = " + emitStringLiteral(v) + ";\n";
+	}
+	if (bakesStores && !nd->optionalStoredAudio.empty()) {
+		code += "  static const ddtype stores[" + std::to_string(nd->optionalStoredAudio.size()) + "] = {";
+		for (size_t k = 0; k < nd->optionalStoredAudio.size(); ++k) {
+			code += (k % 8 == 0 ? "\n    " : " ") + std::string("{ .i = (int64_t)0x")
+				+ juce::String::toHexString((juce::int64)nd->optionalStoredAudio[k].i).toStdString() + "ULL },";
+		}
+		code += "\n  };\n";
+	}
+	code += "  " + body + "\n";
+	if (perLane) {
+		code += "  laneSum += o[0].d;\n";
+		code += "  }\n";
+		if (step.lanes == LaneMode::sum) code += "  dataField[" + std::to_string(step.outputOffset) + "].d = laneSum;\n";
+	}
+	code += "  }\n";
+	return code;
+}
 
 std::string Runner::initializeClang(const RunnerInput& input,
 	const SceneData* scene,
 	const std::vector<std::span<ddtype>>& /*outerInputs*/)
 {
+	// the plan's three groups become the cases of one switch, the run* entry points pick theirs
+	// through the group argument just like they pick their range of steps
+	std::string groups[3];
+	// the frame again in parts that can also run on their own: one per task of frameTasks (3 + t) with
+	// the joining tail last, or the front (-1) and back (-2) of a pipelined frame
+	std::vector<int> partStarts{ input.firstSampleRateStep };
+	std::vector<int> partGroups{ 3 };
+	if (!input.frameTasks.empty()) {
+		partStarts = input.frameTasks;
+		partGroups.clear();
+		for (int p = 0; p < (int)partStarts.size(); ++p) partGroups.push_back(3 + p);
+	}
+	else if (input.pipelineCut >= 0) {
+		partStarts = { input.firstSampleRateStep, input.pipelineCut };
+		partGroups = { -1, -2 };
+	}
+	std::vector<std::string> frameParts(partStarts.size());
+	std::map<std::string, GlobalClangVar> varDeclarations; // by name, nodes naming the same one share it
+	for (int s = 0; s < (int)input.plan.size(); ++s) {
+		const PlanStep& step = input.plan[s];
+		std::string code = emitStep(input, step, s);
+		if (code.empty()) return "";
+		const int group = s < input.firstSampleRateStep ? 0 : s < input.firstChannelStep ? 1 : 2;
+		if (group == 1) {
+			frameParts[std::upper_bound(partStarts.begin(), partStarts.end(), s) - partStarts.begin() - 1] += code;
+		}
+		else {
+			groups[group] += code;
+		}
+
+		for (auto& gv : step.node->getType()->globalVarNames(*step.node, s)) {
+			auto safe = gv;
+			safe.varName = sanitizeIdentifier(gv.varName);
+			varDeclarations.emplace(safe.varName, safe);
+		}
+	}
+
 	std::string emitCode;
-	std::unordered_map<NodeData*, int> nodeIndex;   // node -> ordinal
-	std::unordered_map<NodeData*, int> nodeCounts;  // node -> element count
-	std::unordered_map<NodeData*, int> nodeOffset;  // node -> start offset in dataField
-	std::unordered_map<std::string, GlobalClangVar> varDeclarations;
-
-	// 1) Assign indices and record sizes
-	int idx = 0;
-	int totalElems = 0;
-	for (auto* nd : input.nodesOrder) {
-		const int count = nd->getCompileTimeSize(&input);
-		nodeIndex[nd] = idx;
-		nodeCounts[nd] = count;
-		nodeOffset[nd] = totalElems;      // start of this node’s slice
-		totalElems += count;
-		++idx;
-
-		for (auto& gv : nd->getType()->globalVarNames(*nd, nodeIndex[nd])) {
-			std::string sanitized = sanitizeIdentifier(gv.varName);
-			if (!varDeclarations.count(sanitized)) {
-				auto safe = gv; safe.varName = sanitized;
-				varDeclarations.emplace(sanitized, safe);
+	for (const auto& [_, gv] : varDeclarations) {
+		emitCode += (gv.isStatic ? "static " : "") + gv.type + " " + gv.varName + ";\n";
+	}
+	emitCode += "if (dataFieldSize < " + std::to_string(input.field.size()) + ") return;\n";
+	emitCode += "switch (group) {\n";
+	emitCode += "case 0: {\n" + groups[0] + "} break;\n";
+	emitCode += "case 2: {\n" + groups[2] + "} break;\n";
+	// 1 is the whole frame, anything else one part of it
+	emitCode += "default:\n";
+	for (int p = 0; p < (int)frameParts.size(); ++p) {
+		emitCode += "if (group == 1 || group == " + std::to_string(partGroups[p]) + ") {\n" + frameParts[p] + "}\n";
+	}
+	emitCode += "break;\n";
+	emitCode += "}\n";
+	return emitCode;
+}
+
+
+
+const char* ddtypeClang =
+"#include <stdint.h>\n"
+"#include <math.h>\n"
+"#include <stdlib.h>\n"
+"#include <stdbool.h>\n"
+"typedef union {\n"
+"    double d;\n"
+"    int64_t i;\n"
+"} ddtype;\n";
+
+const juce::String ddtypeClangJ(ddtypeClang);
+
+// every step declares what its node might read, most of it goes unused
+const char* unusedPragmas =
+"#pragma clang diagnostic ignored \"-Wunused-variable\"\n"
+"#pragma clang diagnostic ignored \"-Wunused-parameter\"\n"
+"#pragma clang diagnostic ignored \"-Wunused-const-variable\"\n";
+
+#if WAVIATE_JIT
+static std::atomic<uint64_t> kernelsWithGlobals{ 0 }; // see Runner::initialize
+#endif
+
+const juce::String clangHeader(const juce::String& funcName) {
+	return ddtypeClangJ + UserInputClangJ + "\n" + juce::String(NoiseClang) + "\n" + juce::String(EnvelopeClang) + "\n" + unusedPragmas +
+#ifdef _WIN32
+		"__declspec(dllexport) " +
+#endif
+		"void " + funcName +
+		"(ddtype* dataField, int dataFieldSize, "
+		"ddtype* output, int outputSize, "
+		"ddtype** inputs, int* inputSizes, int numInputs, "
+		"UserInput* u, int group) { ";
+}
+
+const juce::String clangCloser = "}";
+
+// gives every unconnected input its own field slot holding the default value, so the plan can
+// point at it instead of building a temporary every run. -1 marks connected inputs
+static std::unordered_map<NodeData*, std::vector<int>> reserveDefaultSlots(RunnerInput& input) {
+	std::unordered_map<NodeData*, std::vector<int>> slots;
+	for (NodeData* node : input.nodesOrder) {
+		auto& nodeSlots = slots[node];
+		for (int i = 0; i < node->getNumInputs(); ++i) {
+			if (node->getInput(i)) {
+				nodeSlots.push_back(-1);
+			}
+			else {
+				nodeSlots.push_back((int)input.field.size());
+				input.field.push_back(node->defaultValues[i]);
 			}
 		}
+		if (node->getType()->isInputNode) {
+			nodeSlots.push_back((int)input.field.size());
+			input.field.push_back(inputNodeDefault(*node));
+		}
 	}
+	return slots;
+}
 
-	// 2) Emit total requirement and optional guard
-	emitCode += "const int kTotalArenaElems = " + std::to_string(totalElems) + ";\n";
-	emitCode += "(void)kTotalArenaElems;\n";
-	// If you want a cheap guard (won’t crash if caller passes wrong size)
-	emitCode += "if (dataFieldSize < kTotalArenaElems) { /* TODO: handle error */ return; }\n";
+// the types at both ends of a connected edge, with followsInput / any resolved
+static std::pair<InputType, InputType> edgeTypes(NodeData* node, int i) {
+	NodeData* inputNode = node->getInput(i);
+	InputType outboundType = inputNode->getType()->outputType;
+	InputType inboundType = node->getType()->inputs[i].inputType;
+	if (outboundType == InputType::followsInput) {
+		outboundType = inputNode->getTrueType();
+	}
+	if (inboundType == InputType::any) {
+		inboundType = node->getTrueType();
+	}
+	return { outboundType, inboundType };
+}
 
-	// 3) Emit global vars
-	for (const auto& [_, gv] : varDeclarations) {
-		emitCode += (gv.isStatic ? "static " : "") + gv.type + " " + gv.varName + ";\n";
+// the live nodes (NodeData::isLive) nothing needs at compile time, through any number of
+// consumers: a size, an input that has to be known up front. the others stay constants, a change to
+// them recompiles. so do the ones never edited yet, they fold and simplify like the rest
+static std::unordered_set<NodeData*> liveNodes(const RunnerInput& input) {
+	std::unordered_set<NodeData*> live;
+	for (NodeData* node : input.nodesOrder) {
+		if (!node->isLive()) continue;
+		if (node->getType()->liveValues == NodeType::LiveValues::table && node->optionalStoredAudio.empty()) continue;
+		bool neededUpFront = false;
+		std::unordered_set<NodeData*> seen{ node };
+		std::vector<NodeData*> stack{ node };
+		while (!stack.empty() && !neededUpFront) {
+			NodeData* current = stack.back();
+			stack.pop_back();
+			for (auto& [consumer, idx] : current->outputs) {
+				if (!consumer || !consumer->isCopy) continue;
+				neededUpFront = neededUpFront || consumer->getType()->inputs[idx].requiresCompileTimeKnowledge || consumer->needsCompileTimeInputs();
+				if (seen.insert(consumer).second) stack.push_back(consumer);
+			}
+		}
+		if (!neededUpFront) live.insert(node);
 	}
+	return live;
+}
 
-	// 4) Emit per-node code blocks
-	int ord = 0;
-	for (auto* nd : input.nodesOrder) {
-		const int i = nodeIndex.at(nd);
-		const int count = nodeCounts.at(nd);
-		const int startOff = nodeOffset.at(nd);
+// how many custom nodes deep inlineSubScenes goes, past that they run their own runner as before
+constexpr int maxInlineDepth = 16;
+
+// splices the graph behind every custom node into the copies, so the optimizer passes, packField and
+// the emitted C see one flat graph instead of a Runner::run (and a copy of its output) per custom node.
+// the sub-scene's input nodes are bypassed to whatever feeds the custom node, its output node takes
+// over the custom node's consumers. a custom node stays as it is when an edge into it needs a type
+// conversion (bypassing would convert differently) or when its scene contains itself.
+// returns how many custom nodes were inlined
+static int inlineSubScenes(RunnerInput& input) {
+	int inlined = 0;
+	// the scenes each spliced copy sits inside, to catch recursive custom nodes
+	std::unordered_map<NodeData*, std::vector<const SceneData*>> enclosing;
+	for (size_t c = 0; c < input.nodeCopies.size(); ++c) {
+		NodeData* custom = input.nodeCopies[c].get();
+		SceneData* sub = custom->getType()->fromScene;
+		if (!sub || sub->nodeDatas.empty()) continue;
+		std::vector<const SceneData*> chain = enclosing[custom];
+		if ((int)chain.size() >= maxInlineDepth || std::find(chain.begin(), chain.end(), sub) != chain.end()) continue;
+		bool convertsInput = false;
+		for (int i = 0; i < custom->getNumInputs(); ++i) {
+			if (!custom->getInput(i)) continue;
+			auto [outboundType, inboundType] = edgeTypes(custom, i);
+			convertsInput = convertsInput || needsConversion(outboundType, inboundType);
+		}
+		if (convertsInput) continue;
+		chain.push_back(sub);
+
+		// same as storeCopies, except the copies only ever point at each other
+		std::unordered_map<NodeData*, NodeData*> copies;
+		NodeData* subOutput = nullptr;
+		std::unique_lock<std::recursive_mutex> subGuard(SceneData::compileLock); // compiledFor may be sizing them
+		for (NodeData* n : sub->nodeDatas) {
+			input.nodeCopies.push_back(std::make_unique<NodeData>(*n));
+			NodeData* copy = input.nodeCopies.back().get();
+			copy->outputs.clear();
+			copies[n] = copy;
+			enclosing[copy] = chain;
+			if (!subOutput && n->getType()->name == "output") subOutput = copy;
+		}
+		if (!subOutput) subOutput = copies.at(sub->nodeDatas[0]);
+		subGuard.unlock();
+		for (auto& [original, copy] : copies) {
+			for (int i = 0; i < (int)copy->inputNodes.size(); ++i) {
+				auto it = copies.find(original->getInput(i));
+				copy->inputNodes[i] = it != copies.end() ? it->second : nullptr;
+				if (copy->inputNodes[i]) copy->inputNodes[i]->outputs.insert({ copy, i });
+			}
+		}
+
+		for (auto& [original, copy] : copies) {
+			if (!copy->getType()->isInputNode) continue;
+			const int k = copy->inputIndex;
+			NodeData* feed = k >= 0 && k < custom->getNumInputs() ? custom->getInput(k) : nullptr;
+			if (feed) {
+				for (auto [consumer, idx] : std::vector<std::tuple<NodeData*, int>>(copy->outputs.begin(), copy->outputs.end())) {
+					consumer->inputNodes[idx] = feed;
+					feed->outputs.insert({ consumer, idx });
+				}
+				copy->outputs.clear(); // left for removeDeadNodes
+				if (copy == subOutput) subOutput = feed;
+			}
+			else {
+				// reads no outer input any more, see inputNodeDefault
+				copy->inputIndex = -1;
+				if (k >= 0 && k < custom->getNumInputs()) copy->defaultValues.push_back(custom->defaultValues[k]);
+			}
+		}
 
-		emitCode += "{\n";
+		for (auto [consumer, idx] : std::vector<std::tuple<NodeData*, int>>(custom->outputs.begin(), custom->outputs.end())) {
+			consumer->inputNodes[idx] = subOutput;
+			subOutput->outputs.insert({ consumer, idx });
+		}
+		custom->outputs.clear();
+		for (int i = 0; i < custom->getNumInputs(); ++i) {
+			if (NodeData* in = custom->getInput(i)) in->outputs.erase({ custom, i });
+			custom->inputNodes[i] = nullptr;
+		}
+		if (input.outputNode == custom) input.outputNode = subOutput;
+		// the editor's custom node reads its size off the sub-scene's output from now on
+		if (auto it = input.remap.find(custom); it != input.remap.end() && it->second) {
+			input.remap[it->second] = subOutput;
+			input.remap.erase(it);
+		}
+		++inlined;
+	}
+	return inlined;
+}
+
+using ConversionKey = std::pair<NodeData*, InputType>;
+
+// one slot per (producer, wanted type), shared by every consumer that wants that type.
+// same deal as reserveDefaultSlots, has to happen before anyone takes spans into field
+static std::map<ConversionKey, int> reserveConversionSlots(RunnerInput& input) {
+	std::map<ConversionKey, int> slots;
+	for (NodeData* node : input.nodesOrder) {
+		for (int i = 0; i < node->getNumInputs(); ++i) {
+			NodeData* inputNode = node->getInput(i);
+			if (!inputNode) continue;
+			auto [outboundType, inboundType] = edgeTypes(node, i);
+			if (!needsConversion(outboundType, inboundType) || slots.contains({ inputNode, inboundType })) continue;
+			auto [offset, size] = input.safeOwnership.at(inputNode);
+			slots[{ inputNode, inboundType }] = (int)input.field.size();
+			input.field.resize(input.field.size() + size);
+		}
+	}
+	return slots;
+}
+
+// the slots reserved up front cover the graph as drawn, edges rewired by GraphOptimizer::simplify
+// get theirs here. only safe once nothing holds spans into field any more
+static int conversionSlot(RunnerInput& input, std::map<ConversionKey, int>& conversionSlots, const ConversionKey& key, int size) {
+	auto it = conversionSlots.find(key);
+	if (it != conversionSlots.end()) return it->second;
+	const int offset = (int)input.field.size();
+	input.field.resize(input.field.size() + size);
+	conversionSlots[key] = offset;
+	return offset;
+}
+
+// converts a producer's output into its slot right now. used for compile-time known producers,
+// whose converted copy never changes
+static std::span<ddtype> convertOnce(RunnerInput& input, NodeData* node, int i, std::map<ConversionKey, int>& conversionSlots, std::set<ConversionKey>& converted) {
+	NodeData* inputNode = node->getInput(i);
+	auto [outboundType, inboundType] = edgeTypes(node, i);
+	auto [offset, size] = input.safeOwnership.at(inputNode);
+	if (!needsConversion(outboundType, inboundType)) return std::span<ddtype>(input.field.data() + offset, size);
+
+	const ConversionKey key{ inputNode, inboundType };
+	const int destOffset = conversionSlot(input, conversionSlots, key, size);
+	std::span<ddtype> source(input.field.data() + offset, size);
+	std::span<ddtype> dest(input.field.data() + destOffset, size);
+	if (converted.insert(key).second) {
+		convert(source, dest, outboundType, inboundType);
+	}
+	return dest;
+}
 
-		// Arena-backed outputs for non-final nodes
-		if (nd != input.outputNode) {
-			emitCode += "  ddtype* o = dataField + " + std::to_string(startOff) + ";\n";
-			emitCode += "  int osize = " + std::to_string(count) + ";\n";
+static void appendPlanStep(RunnerInput& input, NodeData* node, const std::vector<int>& defaultSlots,
+	std::map<ConversionKey, int>& conversionSlots, std::set<ConversionKey>& converted, const PlanRewrite* rewrite) {
+	auto type = node->getType();
+	PlanStep step{};
+	step.execute = rewrite && rewrite->execute ? rewrite->execute : nullptr;
+	if (!step.execute && type->specialize) step.execute = type->specialize(*node);
+	if (!step.execute) step.execute = type->execute;
+	step.node = node;
+	std::tie(step.outputOffset, step.outputSize) = input.safeOwnership.at(node);
+	step.firstInput = (int)input.planInputs.size();
+	step.numInputs = node->getNumInputs();
+	step.outerInputIndex = -1;
+	step.firstConversion = (int)input.planConversions.size();
+	step.numConversions = 0;
+
+	for (int i = 0; i < node->getNumInputs(); ++i) {
+		PlanInput in{};
+		if (rewrite && rewrite->constantInput == i) {
+			// simplify already folded this operand into its own constant, same length as before
+			in.offset = rewrite->constantOffset;
+			in.size = node->getInput(i) ? std::get<1>(input.safeOwnership.at(node->getInput(i))) : 1;
+		}
+		else if (auto inputNode = node->getInput(i)) {
+			std::tie(in.offset, in.size) = input.safeOwnership.at(inputNode);
+			auto [outboundType, inboundType] = edgeTypes(node, i);
+			if (needsConversion(outboundType, inboundType)) {
+				const ConversionKey key{ inputNode, inboundType };
+				if (input.compileTimeKnown.contains(inputNode)) {
+					convertOnce(input, node, i, conversionSlots, converted);
+				}
+				else if (converted.insert(key).second) {
+					// the first consumer in plan order converts; later ones run at the same rate or
+					// faster, so the copy is always fresh by the time they read it
+					PlanConversion conv{};
+					conv.sourceOffset = in.offset;
+					conv.offset = conversionSlot(input, conversionSlots, key, in.size);
+					conv.size = in.size;
+					conv.outboundType = outboundType;
+					conv.inboundType = inboundType;
+					input.planConversions.push_back(conv);
+					step.numConversions += 1;
+				}
+				in.offset = conversionSlot(input, conversionSlots, key, in.size);
+			}
 		}
 		else {
-			// Final node writes to provided output buffer
-			emitCode += "  ddtype* o = output;\n";
-			emitCode += "  int osize = outputSize;\n";
+			in.offset = defaultSlots[i];
+			in.size = 1;
+		}
+		input.planInputs.push_back(in);
+	}
+
+	if (type->isInputNode) {
+		PlanInput in{};
+		in.offset = defaultSlots.back();
+		in.size = 1;
+		input.planInputs.push_back(in);
+		step.numInputs += 1;
+		step.outerInputIndex = node->inputIndex;
+	}
+	if (type->liveValues == NodeType::LiveValues::table && !node->optionalStoredAudio.empty()) {
+		// a copy of the table in field, where setLiveValue can reach it
+		PlanInput in{};
+		in.offset = (int)input.field.size();
+		in.size = (int)node->optionalStoredAudio.size();
+		input.field.insert(input.field.end(), node->optionalStoredAudio.begin(), node->optionalStoredAudio.end());
+		input.planInputs.push_back(in);
+		step.numInputs += 1;
+	}
+	if (type->stateSize > 0) {
+		// only this step ever touches it, so it stays put in field while the arena moves around it
+		PlanInput in{};
+		in.offset = (int)input.field.size();
+		in.size = type->stateSize;
+		input.field.resize(input.field.size() + type->stateSize);
+		input.planInputs.push_back(in);
+		step.stateInput = step.numInputs;
+		step.numInputs += 1;
+	}
+	if (rewrite && rewrite->fusedPartner) {
+		// the fused kernel writes the partner's output through its last input
+		PlanInput in{};
+		std::tie(in.offset, in.size) = input.safeOwnership.at(rewrite->fusedPartner);
+		input.planInputs.push_back(in);
+		step.numInputs += 1;
+		step.fusedOutput = true;
+	}
+	input.plan.push_back(std::move(step));
+}
+
+constexpr int lineSlots = (int)(cacheLineBytes / sizeof(ddtype));
+
+// best fit over the holes left by dead buffers, register allocator style. offsets are in ddtypes
+class FieldArena {
+public:
+	int allocate(int size, int align) {
+		int best = -1;
+		for (int i = 0; i < (int)holes.size(); ++i) {
+			auto [start, length] = holes[i];
+			const int aligned = alignUp(start, align);
+			if (aligned + size > start + length) continue;
+			if (best < 0 || length < holes[best].second) best = i;
 		}
+		if (best < 0 && !holes.empty() && holes.back().first + holes.back().second == top) {
+			// the last hole is too small but sits at the top, grow into it rather than past it
+			best = (int)holes.size() - 1;
+			top = std::max(top, alignUp(holes[best].first, align) + size);
+			holes[best].second = top - holes[best].first;
+		}
+		if (best < 0) {
+			const int aligned = alignUp(top, align);
+			if (aligned > top) release(top, aligned - top);
+			top = aligned + size;
+			return aligned;
+		}
+		auto [start, length] = holes[best];
+		const int aligned = alignUp(start, align);
+		holes.erase(holes.begin() + best);
+		if (aligned + size < start + length) release(aligned + size, start + length - aligned - size);
+		if (aligned > start) release(start, aligned - start);
+		return aligned;
+	}
 
-		// Numeric props
-		for (auto& [k, v] : nd->getNumericProperties()) {
-			std::string sk = sanitizeIdentifier(k);
-			emitCode += "  double n_" + sk + " = " + emitNumericLiteral(v) + ";\n";
+	void release(int start, int length) {
+		auto it = std::lower_bound(holes.begin(), holes.end(), std::make_pair(start, 0));
+		it = holes.insert(it, { start, length });
+		if (it + 1 != holes.end() && it->first + it->second == (it + 1)->first) {
+			it->second += (it + 1)->second;
+			holes.erase(it + 1);
+		}
+		if (it != holes.begin() && (it - 1)->first + (it - 1)->second == it->first) {
+			(it - 1)->second += it->second;
+			holes.erase(it);
 		}
+	}
+
+	int size() const { return top; }
+
+	static int alignUp(int offset, int align) { return (offset + align - 1) / align * align; }
 
-		// String props
-		for (auto& [k, v] : nd->getProperties()) {
-			emitCode += "  const char* s_" + k + " = \"" + v + "\";\n";
+private:
+	std::vector<std::pair<int, int>> holes; // start, length, sorted by start
+	int top = 0;
+};
+
+// rounded size and alignment of a slice, in ddtypes. anything shorter than a cache line rounds up
+// to a power of two aligned to itself, so no slice ever straddles two lines
+static std::pair<int, int> sliceShape(int size) {
+	size = std::max(size, 1);
+	if (size >= lineSlots) return { FieldArena::alignUp(size, lineSlots), lineSlots };
+	int rounded = 1;
+	while (rounded < size) rounded <<= 1;
+	return { rounded, rounded };
+}
+
+// which steps over the 128-wide note vectors can compute the active lanes alone (PlanStep::lanes). a
+// step can when all of its inputs are note vectors that can, read straight from their producers, and
+// nothing reads its output but steps that can too. sums take the active lanes of their input and give a
+// full output. whatever the caller or a conversion reads keeps every lane. also settles
+// laneReleaseSeconds, how long released notes stay active for this plan
+static void markLaneSteps(RunnerInput& input) {
+	const int n = (int)input.plan.size();
+	std::unordered_map<int, int> writer; // offset, step that writes it
+	std::vector<bool> candidate(n, false);
+	for (int s = 0; s < n; ++s) {
+		PlanStep& step = input.plan[s];
+		const NodeType* type = step.node->getType();
+		writer[step.outputOffset] = s;
+		if (step.numConversions > 0 || step.fusedOutput || step.outerInputIndex >= 0) continue;
+		if (type->executeActiveLanes && type->emitActiveLanes) {
+			candidate[s] = step.outputSize == MIDI_NOTE_COUNT && step.execute == type->execute;
+			continue;
+		}
+		if (!type->laneSum && !(type->laneWise && step.outputSize == MIDI_NOTE_COUNT)) continue;
+		bool lanes = step.numInputs > 0;
+		for (int j = 0; j < step.numInputs && lanes; ++j) {
+			const PlanInput& in = input.planInputs[step.firstInput + j];
+			auto it = writer.find(in.offset);
+			lanes = in.size == MIDI_NOTE_COUNT && it != writer.end() && candidate[it->second];
 		}
+		candidate[s] = lanes;
+	}
 
-		// Optional stored audio → local array (C99)
-		if (!nd->optionalStoredAudio.empty()) {
-			emitCode += "  ddtype stores[" + std::to_string(nd->optionalStoredAudio.size()) + "];\n";
-			for (size_t k = 0; k < nd->optionalStoredAudio.size(); ++k) {
-				emitCode += "  stores[" + std::to_string(k) + "].i = "
-					+ std::to_string(nd->optionalStoredAudio[k].i) + "LL;\n";
+	// consumers come after their producers, so walking back settles every reader of a step first
+	std::vector<bool> full(n, false);
+	auto outputWriter = writer.find(std::get<0>(input.safeOwnership.at(input.outputNode)));
+	if (outputWriter != writer.end()) full[outputWriter->second] = true;
+	for (int s = n - 1; s >= 0; --s) {
+		PlanStep& step = input.plan[s];
+		const NodeType* type = step.node->getType();
+		const bool sparse = candidate[s] && (type->laneSum || !full[s]);
+		step.lanes = !sparse ? LaneMode::all : type->laneSum ? LaneMode::sum : type->laneWise ? LaneMode::each : LaneMode::active;
+		if (step.lanes == LaneMode::active) step.execute = type->executeActiveLanes;
+		if (sparse) continue;
+		for (int j = 0; j < step.numInputs; ++j) {
+			auto it = writer.find(input.planInputs[step.firstInput + j].offset);
+			if (it != writer.end()) full[it->second] = true;
+		}
+		for (int c = 0; c < step.numConversions; ++c) {
+			auto it = writer.find(input.planConversions[step.firstConversion + c].sourceOffset);
+			if (it != writer.end()) full[it->second] = true;
+		}
+	}
+
+	input.laneReleaseSeconds = 0.0;
+	for (const PlanStep& step : input.plan) {
+		const NodeType* type = step.node->getType();
+		if (type->laneRelease) {
+			input.laneReleaseSeconds = std::max(input.laneReleaseSeconds, type->laneRelease(*step.node, input));
+		}
+		if (type->fromScene && step.node->optionalRunnerInput) {
+			input.laneReleaseSeconds = std::max(input.laneReleaseSeconds, step.node->optionalRunnerInput->laneReleaseSeconds);
+		}
+	}
+}
+
+// inputReads and historyLength, what the processor has to keep up in UserInput for this plan. lanes
+// must be settled
+static void markInputReads(RunnerInput& input) {
+	input.inputReads = 0;
+	input.historyLength = 0;
+	for (const PlanStep& step : input.plan) {
+		const NodeType* type = step.node->getType();
+		uint32_t reads = type->inputReads;
+		if ((reads & readsNoteCycles) && step.lanes != LaneMode::all) reads = (reads & ~readsNoteCycles) | readsActiveNoteCycles;
+		input.inputReads |= reads;
+		if (type->historyLength) input.historyLength = std::max(input.historyLength, type->historyLength(*step.node, input));
+		if (type->fromScene && step.node->optionalRunnerInput) {
+			input.inputReads |= step.node->optionalRunnerInput->inputReads;
+			input.historyLength = std::max(input.historyLength, step.node->optionalRunnerInput->historyLength);
+		}
+	}
+	if (input.inputReads & readsNoteCycles) input.inputReads &= ~readsActiveNoteCycles;
+	input.historyLength = std::clamp(input.historyLength, 0, CIRCLEBUFFER_CAPACITY);
+}
+
+constexpr int maxFrameTasks = 8;
+constexpr int minOffloadCost = 512; // roughly ddtypes touched per frame, well above what a handoff costs
+
+static int stepCost(const RunnerInput& input, const PlanStep& step) {
+	int cost = 1 + step.outputSize;
+	for (int c = 0; c < step.numConversions; ++c) {
+		cost += input.planConversions[step.firstConversion + c].size;
+	}
+	return cost;
+}
+
+// steps with state outside field: named values, noise, nested runners. they run in one place only
+static bool hasOutsideState(const PlanStep& step, int order) {
+	const NodeType* type = step.node->getType();
+	return type->fromScene || type->isNondeterministic || !type->globalVarNames(*step.node, order).empty();
+}
+
+// splits the per-frame steps into branches that share no buffer, for runSampleRate to hand to a
+// BranchPool. a step reading from two branches joins them and goes to the tail, so does everything
+// downstream of the tail and every step with state outside field. the branches are packed into tasks
+// by cost and laid out one task after another, the tail last. nothing changes unless enough work would
+// leave the audio thread to pay for the handoff
+static void partitionFrame(RunnerInput& input) {
+	input.frameTasks.clear();
+	const int begin = input.firstSampleRateStep;
+	const int end = input.firstChannelStep;
+	if (end - begin < 2) return;
+
+	std::unordered_map<int, int> writer; // offset, step that writes it
+	std::vector<int> parent(end - begin);
+	std::vector<bool> inTail(end - begin, false);
+	auto find = [&parent](int x) {
+		while (parent[x] != x) x = parent[x] = parent[parent[x]];
+		return x;
+	};
+	for (int s = begin; s < end; ++s) {
+		const PlanStep& step = input.plan[s];
+		const int local = s - begin;
+		parent[local] = local;
+		bool tail = hasOutsideState(step, s);
+		int branch = -1;
+		auto dependOn = [&](int offset) {
+			auto it = writer.find(offset);
+			if (it == writer.end() || it->second == s) return;
+			const int producer = it->second - begin;
+			if (inTail[producer]) {
+				tail = true;
+				return;
 			}
+			const int root = find(producer);
+			if (branch >= 0 && branch != root) tail = true;
+			branch = root;
+		};
+		for (int c = 0; c < step.numConversions; ++c) {
+			const PlanConversion& conv = input.planConversions[step.firstConversion + c];
+			dependOn(conv.sourceOffset);
+			writer[conv.offset] = s;
+		}
+		if (step.fusedOutput) writer[input.planInputs[step.firstInput + step.numInputs - 1].offset] = s;
+		writer[step.outputOffset] = s;
+		for (int i = 0; i < step.numInputs; ++i) {
+			dependOn(input.planInputs[step.firstInput + i].offset);
+		}
+		if (tail) inTail[local] = true;
+		else if (branch >= 0) parent[local] = branch;
+	}
+
+	std::map<int, std::vector<int>> branches; // by root, steps in plan order
+	std::vector<int> tailSteps;
+	for (int s = begin; s < end; ++s) {
+		if (inTail[s - begin]) tailSteps.push_back(s);
+		else branches[find(s - begin)].push_back(s);
+	}
+	if (branches.size() < 2) return;
+
+	// heaviest first onto the lightest task
+	std::vector<std::pair<int, const std::vector<int>*>> byCost;
+	for (auto& [_, steps] : branches) {
+		int cost = 0;
+		for (int s : steps) cost += stepCost(input, input.plan[s]);
+		byCost.push_back({ cost, &steps });
+	}
+	std::sort(byCost.begin(), byCost.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+	struct Task {
+		int cost = 0;
+		std::vector<int> steps;
+	};
+	std::vector<Task> tasks(std::min(maxFrameTasks, (int)byCost.size()));
+	int total = 0;
+	for (auto& [cost, steps] : byCost) {
+		Task& lightest = *std::min_element(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.cost < b.cost; });
+		lightest.cost += cost;
+		lightest.steps.insert(lightest.steps.end(), steps->begin(), steps->end());
+		total += cost;
+	}
+	const int heaviest = std::max_element(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.cost < b.cost; })->cost;
+	if (total - heaviest < minOffloadCost) return;
+
+	std::vector<PlanStep> frame;
+	frame.reserve(end - begin);
+	for (Task& task : tasks) {
+		input.frameTasks.push_back(begin + (int)frame.size());
+		for (int s : task.steps) frame.push_back(std::move(input.plan[s]));
+	}
+	input.frameTasks.push_back(begin + (int)frame.size());
+	for (int s : tailSteps) frame.push_back(std::move(input.plan[s]));
+	std::move(frame.begin(), frame.end(), input.plan.begin() + begin);
+}
+
+// the two stages of a pipelined frame. the front is as much of the frame as fits in half its cost and
+// depends on nothing but itself, the block-rate steps and UserInput; the back is the rest, anything with
+// state outside field (the stages run at the same time, a block apart) and everything downstream of
+// that. the front goes first in the plan and pipelineCut is where the back starts. both stages run the
+// block-rate steps on their own field, so those must not have outside state either
+static void splitPipeline(RunnerInput& input) {
+	input.pipelineCut = -1;
+	const int begin = input.firstSampleRateStep;
+	const int end = input.firstChannelStep;
+	for (int s = 0; s < begin; ++s) {
+		if (hasOutsideState(input.plan[s], s)) return;
+	}
+	int total = 0;
+	for (int s = begin; s < end; ++s) {
+		total += stepCost(input, input.plan[s]);
+	}
+
+	std::unordered_map<int, bool> writtenByFront; // offset, whether the front writes it
+	std::vector<bool> inFront(end - begin, false);
+	int frontCost = 0;
+	int frontSteps = 0;
+	for (int s = begin; s < end; ++s) {
+		const PlanStep& step = input.plan[s];
+		const int cost = stepCost(input, step);
+		bool front = !hasOutsideState(step, s) && frontCost + cost <= total / 2;
+		auto dependOn = [&](int offset) {
+			auto it = writtenByFront.find(offset);
+			if (it != writtenByFront.end() && !it->second) front = false;
+		};
+		for (int c = 0; c < step.numConversions; ++c) {
+			dependOn(input.planConversions[step.firstConversion + c].sourceOffset);
+		}
+		for (int i = 0; i < step.numInputs; ++i) {
+			dependOn(input.planInputs[step.firstInput + i].offset);
+		}
+		for (int c = 0; c < step.numConversions; ++c) {
+			writtenByFront[input.planConversions[step.firstConversion + c].offset] = front;
 		}
+		if (step.fusedOutput) writtenByFront[input.planInputs[step.firstInput + step.numInputs - 1].offset] = front;
+		writtenByFront[step.outputOffset] = front;
+		inFront[s - begin] = front;
+		frontCost += front ? cost : 0;
+		frontSteps += front ? 1 : 0;
+	}
+	if (frontCost < minOffloadCost) return;
 
-		// Inputs
-		if (nd->getType()->isInputNode) {
-			const int pin = nd->inputIndex;
-			emitCode += "  ddtype* i0 = inputs[" + std::to_string(pin) + "];\n";
-			emitCode += "  int     isize0 = inputSizes[" + std::to_string(pin) + "];\n";
+	std::vector<PlanStep> frame;
+	frame.reserve(end - begin);
+	for (bool pass : { true, false }) {
+		for (int s = begin; s < end; ++s) {
+			if (inFront[s - begin] == pass) frame.push_back(std::move(input.plan[s]));
 		}
-		else {
-			for (int j = 0; j < nd->getNumInputs(); ++j) {
-				auto* src = nd->getInput(j);
-				if (src) {
-					const int sIdx = nodeIndex.at(src);
-					const int sCount = nodeCounts.at(src);
-					const int sOff = nodeOffset.at(src);
-					emitCode += "  ddtype* i" + std::to_string(j)
-						+ " = dataField + " + std::to_string(sOff) + ";\n";
-					emitCode += "  int     isize" + std::to_string(j)
-						+ " = " + std::to_string(sCount) + ";\n";
-
-					// (Optional) type-conversion buffer if required
-					// Emit under a condition the same way you did before:
-					//   ddtype* iJ_conv = (ddtype*)malloc(isizeJ * sizeof(ddtype));
-					//   for (...) iJ_conv[k] = convert_ddtype(...);
-					//   iJ = iJ_conv;
-				}
-				else {
-					// Unconnected input → use stack-allocated ddtype
-					auto type = nd->getType()->inputs[j].inputType;
+	}
+	std::move(frame.begin(), frame.end(), input.plan.begin() + begin);
+	input.pipelineCut = begin + frontSteps;
+}
 
-					// Define a local variable
-					emitCode += "  ddtype i" + std::to_string(j) + "_default;\n";
+// lays field out again once the plan is final. what the plan only reads (compile-time values, defaults,
+// folded constants) keeps its own slice up front; step outputs and conversion copies share an arena,
+// each one taking a slice from the step that writes it until the last step that reads it. a buffer
+// read by a faster group than the one that wrote it stays put for good, the faster group comes back
+// to it many times per run
+static void packField(RunnerInput& input) {
+	constexpr int forever = std::numeric_limits<int>::max();
+	const int numSteps = (int)input.plan.size();
+	auto groupOf = [&input](int step) {
+		return step < input.firstSampleRateStep ? 0 : step < input.firstChannelStep ? 1 : 2;
+	};
 
-					// Initialize it
-					if (type == InputType::decimal) {
-						emitCode += "  i" + std::to_string(j) + "_default.d = "
-							+ std::to_string(nd->defaultValues[j].d) + ";\n";
-					}
-					else {
-						emitCode += "  i" + std::to_string(j) + "_default.i = "
-							+ std::to_string(nd->defaultValues[j].i) + ";\n";
-					}
+	struct Buffer {
+		int offset;
+		int size;
+		int firstWrite;
+		int lastRead;
+	};
+	std::vector<Buffer> buffers; // in order of firstWrite
+	std::unordered_map<int, int> bufferAt;
+	auto written = [&](int offset, int size, int step) {
+		if (bufferAt.contains(offset)) return;
+		bufferAt[offset] = (int)buffers.size();
+		buffers.push_back({ offset, size, step, step });
+	};
+	auto read = [&](int offset, int step) {
+		auto it = bufferAt.find(offset);
+		if (it == bufferAt.end()) return;
+		Buffer& buffer = buffers[it->second];
+		buffer.lastRead = std::max(buffer.lastRead, groupOf(step) == groupOf(buffer.firstWrite) ? step : forever);
+	};
 
-					// Pointer to the default
-					emitCode += "  ddtype* i" + std::to_string(j)
-						+ " = &i" + std::to_string(j) + "_default;\n";
-					emitCode += "  int isize" + std::to_string(j) + " = 1;\n";
-				}
+	for (int s = 0; s < numSteps; ++s) {
+		const PlanStep& step = input.plan[s];
+		for (int c = 0; c < step.numConversions; ++c) {
+			const PlanConversion& conv = input.planConversions[step.firstConversion + c];
+			read(conv.sourceOffset, s);
+			written(conv.offset, conv.size, s);
+		}
+		if (step.fusedOutput) {
+			const PlanInput& partner = input.planInputs[step.firstInput + step.numInputs - 1];
+			written(partner.offset, partner.size, s);
+		}
+		written(step.outputOffset, step.outputSize, s);
+		for (int i = 0; i < step.numInputs; ++i) {
+			read(input.planInputs[step.firstInput + i].offset, s);
+		}
+	}
+	auto [outputOffset, outputSize] = input.safeOwnership.at(input.outputNode);
+	if (auto it = bufferAt.find(outputOffset); it != bufferAt.end()) {
+		buffers[it->second].lastRead = forever; // read by whoever called run
+	}
+	if (!input.frameTasks.empty()) {
+		// the frame's tasks run side by side, so nothing one of them writes may give its slice to another
+		const int tasksEnd = input.frameTasks.back();
+		for (Buffer& buffer : buffers) {
+			if (buffer.firstWrite >= input.frameTasks.front() && buffer.firstWrite < tasksEnd) {
+				buffer.lastRead = std::max(buffer.lastRead, tasksEnd - 1);
 			}
 		}
+	}
 
-		// Node body
-		emitCode += "  " + nd->getType()->emitCode(*nd, ord) + "\n";
+	// everything else anyone can still point at
+	std::map<int, int> pinned;
+	auto pin = [&](int offset, int size) {
+		if (bufferAt.contains(offset)) return;
+		pinned[offset] = std::max(pinned[offset], size);
+	};
+	for (auto& [node, ownership] : input.safeOwnership) {
+		if (node) pin(std::get<0>(ownership), std::get<1>(ownership));
+	}
+	for (const PlanInput& in : input.planInputs) {
+		pin(in.offset, in.size);
+	}
+	for (const PlanConversion& conv : input.planConversions) {
+		pin(conv.sourceOffset, conv.size);
+	}
 
-		// (Optional) Free any conversion/default buffers you actually allocated above
-		// emitCode += "  /* free(iJ_conv / iJ defaults if allocated) */\n";
+	std::unordered_map<int, int> moved;
+	int pinnedSize = 0;
+	for (auto& [offset, size] : pinned) {
+		auto [rounded, align] = sliceShape(size);
+		pinnedSize = FieldArena::alignUp(pinnedSize, align);
+		moved[offset] = pinnedSize;
+		pinnedSize += rounded;
+	}
+	const int arenaStart = FieldArena::alignUp(pinnedSize, lineSlots);
 
-		emitCode += "}\n\n";
-		++ord;
+	std::vector<std::vector<int>> lastReads(numSteps);
+	for (int b = 0; b < (int)buffers.size(); ++b) {
+		if (buffers[b].lastRead < numSteps) lastReads[buffers[b].lastRead].push_back(b);
+	}
+	FieldArena arena;
+	std::vector<int> slices(buffers.size());
+	for (int s = 0, b = 0; s < numSteps; ++s) {
+		// hand out this step's slices before taking back its inputs', a kernel never sees its
+		// output alias one of its inputs
+		for (; b < (int)buffers.size() && buffers[b].firstWrite == s; ++b) {
+			auto [rounded, align] = sliceShape(buffers[b].size);
+			slices[b] = arena.allocate(rounded, align);
+			moved[buffers[b].offset] = arenaStart + slices[b];
+		}
+		for (int dead : lastReads[s]) {
+			arena.release(slices[dead], sliceShape(buffers[dead].size).first);
+		}
 	}
 
-	return emitCode;
+	decltype(input.field) field(arenaStart + arena.size());
+	for (auto& [offset, size] : pinned) {
+		std::copy(input.field.begin() + offset, input.field.begin() + offset + size, field.begin() + moved.at(offset));
+	}
+	input.fieldBytesUnpacked = input.field.size() * sizeof(ddtype);
+	input.fieldBytes = field.size() * sizeof(ddtype);
+	input.field = std::move(field);
+
+	for (auto& [node, ownership] : input.safeOwnership) {
+		if (node) std::get<0>(ownership) = moved.at(std::get<0>(ownership));
+	}
+	for (PlanStep& step : input.plan) {
+		step.outputOffset = moved.at(step.outputOffset);
+	}
+	for (PlanInput& in : input.planInputs) {
+		in.offset = moved.at(in.offset);
+	}
+	for (PlanConversion& conv : input.planConversions) {
+		conv.sourceOffset = moved.at(conv.sourceOffset);
+		conv.offset = moved.at(conv.offset);
+	}
 }
 
+// field must not move after this, the steps hold spans into it
+static void resolvePlanSpans(RunnerInput& input) {
+	ddtype* base = input.field.data();
+	for (auto& [node, ownership] : input.safeOwnership) {
+		if (node) {
+			auto [offset, size] = ownership;
+			input.nodeOwnership[node] = std::span<ddtype>(base + offset, size);
+		}
+	}
+	for (auto& step : input.plan) {
+		step.output = std::span<ddtype>(base + step.outputOffset, step.outputSize);
+		step.inputs.clear();
+		step.inputs.reserve(step.numInputs);
+		for (int i = 0; i < step.numInputs; ++i) {
+			const PlanInput& in = input.planInputs[step.firstInput + i];
+			step.inputs.emplace_back(base + in.offset, in.size);
+		}
+		step.outerDefault = step.node->getType()->isInputNode ? step.inputs.back() : std::span<ddtype>();
+		step.laneInputs.assign(step.lanes == LaneMode::each || step.lanes == LaneMode::sum ? step.numInputs : 0, std::span<ddtype>());
+	}
+	for (auto& conv : input.planConversions) {
+		conv.source = std::span<ddtype>(base + conv.sourceOffset, conv.size);
+		conv.dest = std::span<ddtype>(base + conv.offset, conv.size);
+	}
+	auto [offset, size] = input.safeOwnership.at(input.outputNode);
+	input.outputSpan = std::span<ddtype>(base + offset, size);
+}
 
+// points copies of plan steps and conversions at another copy of field, starting at to
+static void rebaseSpans(const RunnerInput& input, ddtype* to, std::vector<PlanStep>& steps, std::vector<PlanConversion>& conversions) {
+	const ddtype* from = input.field.data();
+	auto rebase = [&](std::span<ddtype> span) {
+		const bool inField = span.data() >= from && span.data() < from + input.field.size();
+		return inField ? std::span<ddtype>(to + (span.data() - from), span.size()) : span;
+	};
+	for (PlanStep& step : steps) {
+		step.output = rebase(step.output);
+		for (auto& in : step.inputs) in = rebase(in);
+		step.outerDefault = rebase(step.outerDefault);
+	}
+	for (PlanConversion& conv : conversions) {
+		conv.source = rebase(conv.source);
+		conv.dest = rebase(conv.dest);
+	}
+}
 
-const char* ddtypeClang =
-"#include <stdint.h>\n"
-"#include <math.h>\n"
-"#include <stdlib.h>\n"
-"#include <stdbool.h>\n"
-"typedef union {\n"
-"    double d;\n"
-"    int64_t i;\n"
-"} ddtype;\n";
+// the pipeline front's own field and steps over it, and the values that cross over to the back: what the
+// front writes and the back or whoever called run reads. field must be final
+static void buildPipelineFront(RunnerInput& input) {
+	input.pipelineBoundary.clear();
+	input.pipelineBoundarySize = 0;
+	input.pipelineField.clear();
+	input.pipelinePlan.clear();
+	input.pipelineConversions.clear();
+	if (input.pipelineCut < 0) return;
+
+	std::map<int, int> written; // offset, size
+	for (int s = input.firstSampleRateStep; s < input.pipelineCut; ++s) {
+		const PlanStep& step = input.plan[s];
+		for (int c = 0; c < step.numConversions; ++c) {
+			const PlanConversion& conv = input.planConversions[step.firstConversion + c];
+			written[conv.offset] = conv.size;
+		}
+		if (step.fusedOutput) {
+			const PlanInput& partner = input.planInputs[step.firstInput + step.numInputs - 1];
+			written[partner.offset] = partner.size;
+		}
+		written[step.outputOffset] = step.outputSize;
+	}
+	std::map<int, int> boundary;
+	auto read = [&](int offset) {
+		if (auto it = written.find(offset); it != written.end()) boundary.insert(*it);
+	};
+	for (int s = input.pipelineCut; s < (int)input.plan.size(); ++s) {
+		const PlanStep& step = input.plan[s];
+		for (int c = 0; c < step.numConversions; ++c) {
+			read(input.planConversions[step.firstConversion + c].sourceOffset);
+		}
+		for (int i = 0; i < step.numInputs; ++i) {
+			read(input.planInputs[step.firstInput + i].offset);
+		}
+	}
+	read(std::get<0>(input.safeOwnership.at(input.outputNode)));
+	int size = 0;
+	for (auto& [_, length] : boundary) size += length;
+	if (size > RunnerInput::maxPipelineBoundary) {
+		input.pipelineCut = -1;
+		return;
+	}
+	input.pipelineBoundary.assign(boundary.begin(), boundary.end());
+	input.pipelineBoundarySize = size;
 
-const juce::String ddtypeClangJ(ddtypeClang);
+	input.pipelineField = input.field;
+	input.pipelinePlan.assign(input.plan.begin(), input.plan.begin() + input.pipelineCut);
+	input.pipelineConversions = input.planConversions;
+	rebaseSpans(input, input.pipelineField.data(), input.pipelinePlan, input.pipelineConversions);
+}
 
-const juce::String clangHeader(uint64_t x) {
-	return ddtypeClangJ + UserInputClangJ +
-#ifdef _WIN32
-		"__declspec(dllexport) " +
-#endif
-		"void nodeTypeOutput" + juce::String(x) +
-		"(ddtype* dataField, int dataFieldSize, "
-		"ddtype* output, int outputSize, "
-		"ddtype** inputs, int* inputSizes, int numInputs) { ";
+// a VoiceState per voice, each with a copy of field as it is now. voices run side by side, so none of
+// them when some step keeps state outside field
+static void buildVoices(RunnerInput& input) {
+	input.voices.clear();
+	input.voiceField.clear();
+	if (input.numVoices <= 0) return;
+	for (int s = 0; s < (int)input.plan.size(); ++s) {
+		if (hasOutsideState(input.plan[s], s)) return;
+	}
+	input.voiceField = input.field;
+	input.voices.resize(input.numVoices);
+	for (VoiceState& voice : input.voices) {
+		voice.field = input.field;
+		voice.plan = input.plan;
+		voice.conversions = input.planConversions;
+		rebaseSpans(input, voice.field.data(), voice.plan, voice.conversions);
+		voice.input = std::make_shared<UserInput>();
+	}
 }
 
-const juce::String clangCloser = "}";
+std::unique_ptr<RunnerInput> Runner::instantiate(const std::shared_ptr<const RunnerInput>& compiled)
+{
+	auto instance = std::make_unique<RunnerInput>();
+	instance->instanceOf = compiled;
+	instance->field = compiled->field;
+	instance->plan = compiled->plan;
+	instance->planInputs = compiled->planInputs;
+	instance->planConversions = compiled->planConversions;
+	rebaseSpans(*compiled, instance->field.data(), instance->plan, instance->planConversions);
+	instance->firstSampleRateStep = compiled->firstSampleRateStep;
+	instance->firstChannelStep = compiled->firstChannelStep;
+	instance->dependsOnChannel = compiled->dependsOnChannel;
+	instance->outputNode = compiled->outputNode;
+	instance->outputSpan = std::span<ddtype>(instance->field.data() + (compiled->outputSpan.data() - compiled->field.data()), compiled->outputSpan.size());
+	instance->liveSlots = compiled->liveSlots;
+	instance->clangInputPtrs.resize(compiled->clangInputPtrs.size());
+	instance->clangInputSizes.resize(compiled->clangInputSizes.size());
+	for (auto& [node, sub] : compiled->subRunners) {
+		if (sub->instanceOf) instance->subRunners[node] = instantiate(sub->instanceOf);
+	}
+	return instance;
+}
 
 void Runner::initialize(RunnerInput& input, class SceneData* scene,
 	const std::vector<std::span<ddtype>>& outerInputs)
 {
 	input.nodesOrder.clear();
+	input.subRunners.clear();
+	input.plan.clear();
+	input.planInputs.clear();
+	input.planConversions.clear();
+	input.firstSampleRateStep = 0;
+	input.firstChannelStep = 0;
+	input.dependsOnChannel = false;
+	input.frameTasks.clear();
+	input.pipelineCut = -1;
+	input.outputSpan = std::span<ddtype>();
+	input.clangInputPtrs.clear();
+	input.clangInputSizes.clear();
 	input.nodeOwnership.clear();
 	input.safeOwnership.clear();
 	input.nodeCompileTimeOutputs.clear();
+	input.compileTimeKnown.clear();
 	input.nodeCopies.clear();
 	input.remap.clear();
+	input.liveSlots.clear();
+	input.scenesInlined = 0;
+	input.nodesMerged = 0;
+	input.nodesRemoved = 0;
+	input.rewriteCounts.clear();
+	input.compiledFunc.store(nullptr, std::memory_order_release);
+	input.kernelName.clear();
+	input.fieldBytesUnpacked = 0;
+	input.fieldBytes = 0;
 	input.field.clear();
 	input.clangcode = "";
 	if (!scene) return;
@@ -839,6 +2039,11 @@ void Runner::initialize(RunnerInput& input, class SceneData* scene,
 	if (!editorOutput) editorOutput = input.nodeCopies[0].get();
 	input.outputNode = editorOutput;
 
+	input.scenesInlined = inlineSubScenes(input);
+
+	input.nodesMerged = GraphOptimizer::mergeDuplicateNodes(input);
+	input.nodesRemoved = GraphOptimizer::removeDeadNodes(input);
+
 	for (auto& newNode : input.nodeCopies)
 		newNode->markUncompiled(&input);
 
@@ -847,6 +2052,9 @@ void Runner::initialize(RunnerInput& input, class SceneData* scene,
 		findRemainingSizes(node.get(), input, outerInputs, *userInput); // just warms the cache
 
 	setupIterative(input.outputNode, input);
+	auto defaultSlots = reserveDefaultSlots(input);
+	auto conversionSlots = reserveConversionSlots(input);
+	std::set<ConversionKey> converted;
 
 	for (auto& [node, ownership] : input.safeOwnership) {
 		if (node) {
@@ -855,36 +2063,21 @@ void Runner::initialize(RunnerInput& input, class SceneData* scene,
 		}
 	}
 
-	juce::String clangCode = initializeClang(input, scene, outerInputs);
-	input.clangcode = (clangHeader(globalCompileCounter) + clangCode + clangCloser).toStdString();
-
-	
-#ifndef USE_GRAPH_EXEC
-	llvm::OptimizationLevel OX;
-	switch (input.optLevel) {
-	case OptLevel::high:           OX = llvm::OptimizationLevel::O3; break;
-	case OptLevel::medium:         OX = llvm::OptimizationLevel::O2; break;
-	case OptLevel::low:            OX = llvm::OptimizationLevel::O1; break;
-	case OptLevel::minimal:        OX = llvm::OptimizationLevel::O0; break;
-	case OptLevel::prioritizeSize: OX = llvm::OptimizationLevel::Oz; break;
-	case OptLevel::tradeOffSize:   OX = llvm::OptimizationLevel::Os; break;
-	}
-#ifdef USE_EMBEDDED_CLANG
-	input.compiledFunc = compileNodeKernel(
-		input.clangcode, (juce::String("nodeTypeOutput") + juce::String(globalCompileCounter)).toStdString(), OX);
-#else 
-	input.compiledFunc = compileNodeKernelDll(
-		input.clangcode,
-		(juce::String("nodeTypeOutput") + juce::String(globalCompileCounter)).toStdString(), input.optLevel);
-		//,OX);
-#endif
-#endif
-
-	// Handle compile-time known nodes
+	// Handle compile-time known nodes. live nodes and everything computed from them can change while
+	// the plan plays, so they stay out of it: live outputs are evaluated once for their first value and
+	// then only written by setLiveValue, the rest becomes (block-rate) steps
+	auto live = liveNodes(input);
+	std::unordered_set<NodeData*> fedByLive;
 	std::vector<NodeData*> tempNodesOrder;
 	for (NodeData* node : input.nodesOrder) {
-		if (node->isCompileTimeKnown()) {
-			input.compileTimeKnown.insert(node);
+		bool fromLive = live.contains(node);
+		for (int i = 0; i < node->getNumInputs(); ++i) {
+			fromLive = fromLive || fedByLive.contains(node->getInput(i));
+		}
+		if (fromLive) fedByLive.insert(node);
+		const bool liveOutput = live.contains(node) && node->getType()->liveValues == NodeType::LiveValues::output;
+		if (liveOutput || (!fromLive && node->isCompileTimeKnown())) {
+			if (!liveOutput) input.compileTimeKnown.insert(node);
 
 			std::vector<ddtype> extraspace(node->getNumInputs());
 			for (int i = 0; i < node->getNumInputs(); ++i)
@@ -893,14 +2086,14 @@ void Runner::initialize(RunnerInput& input, class SceneData* scene,
 			auto& output = input.nodeOwnership[node];
 			std::vector<std::span<ddtype>> inputs;
 			for (int i = 0; i < node->getNumInputs(); ++i) {
-				if (auto* nodeInput = node->getInput(i))
-					inputs.push_back(input.nodeOwnership[nodeInput]);
+				if (node->getInput(i))
+					inputs.push_back(convertOnce(input, node, i, conversionSlots, converted));
 				else
 					inputs.push_back(std::span<ddtype>(&extraspace[i], 1));
 			}
 
-			ddtype defaultIfNeeded = node->getNumericProperties().contains("defaultValue")
-				? node->getNumericProperty("defaultValue") : 0.0;
+			ddtype defaultIfNeeded = node->defaultValues.size() > (size_t)node->getNumInputs() ? node->defaultValues.back()
+				: node->getNumericProperties().contains("defaultValue") ? node->getNumericProperty("defaultValue") : 0.0;
 			std::span<ddtype> spanOverDefaultIfNeeded(&defaultIfNeeded, 1);
 
 			if (node->getType()->isInputNode) {
@@ -918,14 +2111,109 @@ void Runner::initialize(RunnerInput& input, class SceneData* scene,
 		}
 	}
 
-	for (auto& node : input.nodeCopies) {
-		if (remap.contains(node.get())) {
-			auto sceneNode = remap[node.get()];
-			if (sceneNode)
-				sceneNode->setCompileTimeSize(scene, node->getCompileTimeSize(&input));
-		}
+	// scene nodes whose copy was merged away map to the survivor, removed ones aren't in remap at all
+	for (auto& [from, to] : remap) {
+		if (from && to && !from->isCopy)
+			from->setCompileTimeSize(scene, to->getCompileTimeSize(&input));
 	}
 
 	input.nodesOrder = tempNodesOrder;
+	auto rewrites = GraphOptimizer::simplify(input);
+
+	// split what's left by how often it can change. anything fed (even indirectly) by a per-sample
+	// source has to run every sample, the rest only sees host/MIDI state and runs once per sub-block.
+	// per-sample nodes are split again: only what is fed by a channel reader (stereo input, sidechain,
+	// the history filters, or a sub-scene containing one) runs once per channel, the rest once per frame.
+	// each group only reads from its own or earlier groups, so the concatenation stays in dependency order
+	std::unordered_set<NodeData*> perSample;
+	std::unordered_set<NodeData*> perChannel;
+	std::vector<NodeData*> sampleRateNodes;
+	std::vector<NodeData*> channelNodes;
+	auto addStep = [&](NodeData* node) {
+		auto it = rewrites.find(node);
+		const PlanRewrite* rewrite = it != rewrites.end() ? &it->second : nullptr;
+		if (rewrite && rewrite->skip) return; // bypassed, or computed by its fused partner
+		appendPlanStep(input, node, defaultSlots.at(node), conversionSlots, converted, rewrite);
+	};
+	for (NodeData* node : input.nodesOrder) {
+		auto type = node->getType();
+		bool readsChannel = type->dependsOnChannel
+			|| (type->fromScene && (!node->optionalRunnerInput || node->optionalRunnerInput->dependsOnChannel));
+		bool varies = (type->alwaysOutputsRuntimeData && !type->isBlockRate) || type->fromScene || type->isInputNode || readsChannel;
+		for (int i = 0; i < node->getNumInputs(); ++i) {
+			varies = varies || perSample.contains(node->getInput(i));
+			readsChannel = readsChannel || perChannel.contains(node->getInput(i));
+		}
+		if (readsChannel) {
+			perSample.insert(node);
+			perChannel.insert(node);
+			channelNodes.push_back(node);
+		}
+		else if (varies) {
+			perSample.insert(node);
+			sampleRateNodes.push_back(node);
+		}
+		else {
+			addStep(node);
+		}
+	}
+	input.firstSampleRateStep = (int)input.plan.size();
+	for (NodeData* node : sampleRateNodes) {
+		addStep(node);
+	}
+	input.firstChannelStep = (int)input.plan.size();
+	for (NodeData* node : channelNodes) {
+		addStep(node);
+	}
+	input.dependsOnChannel = !channelNodes.empty();
+	markLaneSteps(input);
+	markInputReads(input);
+	if (input.pipelined) splitPipeline(input);
+	else partitionFrame(input);
+	packField(input);
+	resolvePlanSpans(input);
+	buildPipelineFront(input);
+	buildVoices(input);
+
+	for (NodeData* node : live) {
+		if (node->getType()->liveValues == NodeType::LiveValues::output) {
+			input.liveSlots.insert({ node->original, input.safeOwnership.at(node) });
+		}
+	}
+	for (const PlanStep& step : input.plan) {
+		if (step.node->getType()->liveValues == NodeType::LiveValues::table && live.contains(step.node)) {
+			const PlanInput& table = input.planInputs[step.firstInput + step.node->getNumInputs()];
+			input.liveSlots.insert({ step.node->original, { table.offset, table.size } });
+		}
+	}
+
+	// runClang's buffers, so the audio thread never has to size them
+	int numInputNodes = 0;
+	for (auto& node : input.nodeCopies) {
+		numInputNodes += node->getType()->isInputNode ? 1 : 0;
+	}
+	input.clangInputPtrs.assign(numInputNodes, nullptr);
+	input.clangInputSizes.assign(numInputNodes, 0);
+
+#if WAVIATE_JIT
+	// generated from the final plan, so the kernel shares its field layout and can take over from it.
+	// empty when some step has no C, then the plan is all there is
+	std::string clangCode = initializeClang(input, scene, outerInputs);
+	if (!clangCode.empty()) {
+		// named after what it computes and how hard it's optimized: the same graph gets the same symbol,
+		// and the JIT or KernelCache can hand back the kernel it built last time. named values live in
+		// module globals though, so a plan with any gets a module of its own, no one else's state
+		input.kernelName = "nodeTypeOutput_" + KernelCache::keyFor(clangCode, "") + "_O" + std::to_string((int)input.optLevel);
+		for (int s = 0; s < (int)input.plan.size(); ++s) {
+			const PlanStep& step = input.plan[s];
+			if (!step.node->getType()->globalVarNames(*step.node, s).empty()) {
+				input.kernelName += "_" + std::to_string(++kernelsWithGlobals);
+				break;
+			}
+		}
+		input.clangcode = (clangHeader(input.kernelName) + juce::String(clangCode) + clangCloser).toStdString();
+	}
+	// built later by RunnerCompiler, if at all. the plan is what plays until then
+#endif
 }
 
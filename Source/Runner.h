@@ -15,8 +15,19 @@
 #include <span>
 #include <memory>
 #include <mutex>
+#include <string>
 #include "ddtype.h"
+#include "OptLevel.h"
+#include "RunnerInput.h"
 #include "UserInput.h"
+
+// WAVIATE_JIT=1 builds the embedded clang in: every runner's plan is also generated as C and compiled
+// by RunnerCompiler into a kernel that takes over from the interpreter. a preprocessor define of the
+// build configuration. without it the plan is all that plays and no kernel source is generated
+#ifndef WAVIATE_JIT
+#define WAVIATE_JIT 0
+#endif
+
 class juce::String;
 class Runner {
 public:
@@ -27,6 +38,33 @@ public:
     
 
     static std::span<ddtype> run(const class RunnerInput* runnerInput, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs);
+    // everything from here to NodeType::execute runs on the audio thread, see RealtimeCheck.h
+    // block mode: call runBlockRate once at the start of each sub-block, then for every sample frame
+    // runSampleRate once and runChannel once per output channel (after setting isStereoRight)
+    static void runBlockRate(const RunnerInput* runnerInput, UserInput& userInput);
+    // with a pool, a frame split into tasks at initialize (RunnerInput::frameTasks) runs them on its workers
+    static void runSampleRate(const RunnerInput* runnerInput, UserInput& userInput, class BranchPool* pool = nullptr);
+    static std::span<ddtype> runChannel(const RunnerInput* runnerInput, UserInput& userInput);
+    // pipelined rendering (RunnerInput::pipelineCut): the front runs on pipelineField a block ahead and
+    // leaves what the back needs in boundary, the back takes it from there in place of runSampleRate.
+    // the front does nothing and the back runs the whole frame when the runner wasn't split
+    static void runBlockRateFront(const RunnerInput* runnerInput, UserInput& userInput);
+    static void runSampleRateFront(const RunnerInput* runnerInput, UserInput& userInput, std::span<ddtype> boundary);
+    static void runSampleRateBack(const RunnerInput* runnerInput, UserInput& userInput, std::span<const ddtype> boundary);
+    // polyphonic rendering: voice v of the runner (RunnerInput::voices) on its own field, from its own
+    // UserInput. group as in runClang: the block-rate steps (0), the frame (1) or one channel (2).
+    // returns the voice's output. resetVoice puts the voice back the way it started, for a new note
+    static std::span<ddtype> runVoice(const RunnerInput* runnerInput, int voice, int group);
+    static void resetVoice(const RunnerInput* runnerInput, int voice);
+    // writes one value of a live node (see NodeType::liveValues) into every slot it has in runner,
+    // between runs. block-rate steps reading it pick it up on the next runBlockRate
+    // the instances of custom nodes that weren't inlined (RunnerInput::subRunners) get it too
+    static void setLiveValue(RunnerInput* runner, const NodeData* node, int index, ddtype value);
+    // what setLiveValue last left at index, false when runner has no slot for node there
+    static bool getLiveValue(const RunnerInput* runner, const NodeData* node, int index, ddtype& value);
+    // whether setLiveValue reaches every place node plays in runner, nested instances included: there's
+    // at least one slot and they all take size values
+    static bool hasLiveSlots(const RunnerInput& runner, const NodeData* node, int size);
     static std::span<ddtype> getNodeField(NodeData*, std::unordered_map<NodeData*, std::span<ddtype>>& nodeOwnership);
     static bool containsNodeField(NodeData*, std::unordered_map<NodeData*, std::span<ddtype>>& nodeOwnership);
     static std::vector<ddtype> findRemainingSizes(NodeData* root, RunnerInput& inlineInstance, const std::vector<std::span<ddtype>>& outerInputs, UserInput& userInput);
@@ -36,7 +74,13 @@ public:
     
 
     static void initialize(RunnerInput& input, class SceneData* scene, const std::vector<std::span<ddtype>>& outerInputs);
+    // a runner of its own over compiled's plan and nodes: a fresh copy of its field, and instances of its
+    // own of whatever compiled nests in turn. compiled must be initialized and is only read from here on
+    static std::unique_ptr<RunnerInput> instantiate(const std::shared_ptr<const RunnerInput>& compiled);
     static std::string initializeClang(const class RunnerInput& input, const class SceneData* scene, const std::vector<std::span<ddtype>>& /*outerInputs*/);
-    static std::span<ddtype> runClang(RunnerInput* runnerInputP, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs);
+    static std::span<ddtype> runClang(const RunnerInput* runnerInputP, int group, UserInput& userInput, const std::vector<std::span<ddtype>>& outerInputs);
+    // slow (clang + LLVM), call it from RunnerCompiler's thread rather than the message thread.
+    // null when the JIT isn't built in
+    static NodeFn compileKernel(const std::string& sourceCode, const std::string& funcName, OptLevel optLevel);
 private:
 };
\ No newline at end of file
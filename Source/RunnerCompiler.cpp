@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    RunnerCompiler.cpp
+
+  ==============================================================================
+*/
+
+#include "RunnerCompiler.h"
+#include "Runner.h"
+
+RunnerCompiler::RunnerCompiler() : juce::Thread("Waviate kernel compiler")
+{
+}
+
+RunnerCompiler::~RunnerCompiler()
+{
+    stop();
+}
+
+void RunnerCompiler::submit(const RunnerInput& runner)
+{
+    if (runner.clangcode.empty()) return;
+    Job job{ &runner, latestGeneration.fetch_add(1, std::memory_order_acq_rel) + 1,
+        runner.clangcode, runner.kernelName, runner.optLevel };
+    {
+        std::lock_guard<realtime::CheckedMutex> guard(lock);
+        pending = std::move(job);
+    }
+    if (!isThreadRunning()) {
+        startThread();
+    }
+    notify();
+}
+
+void RunnerCompiler::stop()
+{
+    latestGeneration.fetch_add(1, std::memory_order_acq_rel); // whatever is in flight is stale now
+    signalThreadShouldExit();
+    notify();
+    // a compile can't be interrupted, give it the time it takes
+    stopThread(-1);
+    cancelPendingUpdate();
+    std::lock_guard<realtime::CheckedMutex> guard(lock);
+    pending.reset();
+    finished.reset();
+}
+
+bool RunnerCompiler::isStale(uint64_t generation) const noexcept
+{
+    return generation != latestGeneration.load(std::memory_order_acquire);
+}
+
+void RunnerCompiler::run()
+{
+    while (!threadShouldExit()) {
+        wait(-1);
+        // still being edited, hold off until it settles
+        while (!threadShouldExit() && wait(settleMs)) {}
+        if (threadShouldExit()) return;
+
+        std::optional<Job> job;
+        {
+            std::lock_guard<realtime::CheckedMutex> guard(lock);
+            job.swap(pending);
+        }
+        if (!job || isStale(job->generation)) continue;
+
+        NodeFn kernel = nullptr;
+        try {
+            kernel = Runner::compileKernel(job->source, job->funcName, job->optLevel);
+        }
+        catch (const std::exception& e) {
+            DBG("compiler: " << job->funcName << " failed, staying interpreted: " << e.what());
+            continue;
+        }
+        if (!kernel) continue;
+        if (isStale(job->generation)) {
+            DBG("compiler: " << job->funcName << " superseded while compiling, dropped");
+            continue;
+        }
+        {
+            std::lock_guard<realtime::CheckedMutex> guard(lock);
+            finished = Result{ job->runner, job->generation, kernel };
+        }
+        triggerAsyncUpdate();
+    }
+}
+
+void RunnerCompiler::handleAsyncUpdate()
+{
+    std::optional<Result> result;
+    {
+        std::lock_guard<realtime::CheckedMutex> guard(lock);
+        result.swap(finished);
+    }
+    if (!result || isStale(result->generation)) return;
+    if (onCompiled) {
+        onCompiled(const_cast<RunnerInput*>(result->runner), result->kernel);
+    }
+}
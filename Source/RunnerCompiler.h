@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    RunnerCompiler.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "RunnerInput.h"
+#include "RealtimeCheck.h"
+
+// builds the JIT kernel of a runner on a worker thread while its interpreted plan is already playing.
+// submit takes a snapshot of the generated source, so the worker never touches the graph or the
+// runner itself. only the latest submission is ever compiled: a burst of edits is waited out, jobs
+// superseded while queued are dropped, and one superseded mid-compile is thrown away when it returns.
+// finished kernels are handed back on the message thread through onCompiled
+class RunnerCompiler : private juce::Thread, private juce::AsyncUpdater {
+public:
+    RunnerCompiler();
+    ~RunnerCompiler() override;
+
+    // message thread only
+    void submit(const RunnerInput& runner);
+    void stop();
+    std::function<void(RunnerInput* runner, NodeFn kernel)> onCompiled;
+
+    static constexpr int settleMs = 150; // an edit within this long of the last restarts the wait
+
+private:
+    struct Job {
+        const RunnerInput* runner;
+        uint64_t generation;
+        std::string source;
+        std::string funcName;
+        OptLevel optLevel;
+    };
+    struct Result {
+        const RunnerInput* runner;
+        uint64_t generation;
+        NodeFn kernel;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+    bool isStale(uint64_t generation) const noexcept;
+
+    realtime::CheckedMutex lock; // never the audio thread's, it only ever sees the runners
+    std::optional<Job> pending;   // guarded by lock
+    std::optional<Result> finished; // guarded by lock
+    std::atomic<uint64_t> latestGeneration{ 0 };
+};
@@ -9,34 +9,166 @@
 */
 
 #pragma once
+#include <atomic>
 #include <mutex>
+#include <memory>
 #include <unordered_map>
 #include <span>
 #include <unordered_set>
 #include <vector>
+#include <map>
+#include <string>
 #include "ddtype.h"
+#include "AlignedAllocator.h"
 #include "OptLevel.h"
+#include "InputType.h"
 
+// group selects the block-rate (0), per-frame (1) or per-channel (2) steps, see Runner::runClang. parts
+// of the frame have groups of their own, see Runner::initializeClang
 using NodeFn = void(*)(ddtype* dataField, int dataFieldSize,
     ddtype* output, int outputSize,
     ddtype** inputs, int* inputSizes, int numInputs,
-    struct UserInput* u);
+    struct UserInput* u, int group);
 
 
 class NodeData;
+
+// where one input of a plan step reads from in RunnerInput::field, and the conversion it needs
+struct PlanInput {
+    int offset;   // the producer's output, or its converted copy when the types differ
+    int size;
+};
+
+// copies a producer's output into the consumer's type. resolved by Runner::initialize, so an edge
+// that doesn't need one costs nothing at runtime
+struct PlanConversion {
+    int sourceOffset;
+    int offset;
+    int size;
+    InputType outboundType;
+    InputType inboundType;
+    std::span<ddtype> source;
+    std::span<ddtype> dest;
+};
+
+// how a step goes over the 128-wide note vectors (see UserInput::activeLanes). all: every lane, as
+// execute always did. active: a note source writing the active lanes only (NodeType::executeActiveLanes).
+// each: the node once per active lane on one-element views of its buffers. sum: the same, adding up the
+// one-element outputs into the step's only one
+enum class LaneMode : uint8_t { all, active, each, sum };
+
+// the parts of UserInput the processor only keeps up for plans that read them (NodeType::inputReads,
+// RunnerInput::inputReads). the rest of UserInput is always there
+enum InputRead : uint32_t {
+    readsNoteCycles = 1 << 0,       // noteCycle, every lane
+    readsActiveNoteCycles = 1 << 1, // noteCycle on the active lanes only
+    readsHistories = 1 << 2,        // the per-channel output histories
+    readsHostValues = 1 << 3,       // dawParams and midiCCValues, as far as voices go
+};
+
+// one node invocation, pre-resolved by Runner::initialize so the audio thread walks a flat array
+// instead of hashing into nodeOwnership and building input vectors every sample
+struct PlanStep {
+    void(*execute)(const NodeData&, struct UserInput&, const std::vector<std::span<ddtype>>&, std::span<ddtype>, const class RunnerInput&);
+    NodeData* node;
+    int outputOffset;
+    int outputSize;
+    int firstInput;       // index into RunnerInput::planInputs
+    int numInputs;        // includes the outer input slot of input nodes
+    int outerInputIndex;  // input nodes only, -1 otherwise
+    int firstConversion;  // index into RunnerInput::planConversions, run right before execute
+    int numConversions;
+    bool fusedOutput = false; // the last input is the fused partner's output, written here rather than read
+    LaneMode lanes = LaneMode::all; // lanes no later step reads are left stale
+    int stateInput = -1;  // the input holding the node's state (NodeType::stateSize), written as well as read
+    // spans over field resolved from the offsets above. input nodes repoint their last one at the
+    // caller's outer input on every run, hence mutable
+    mutable std::vector<std::span<ddtype>> inputs;
+    std::span<ddtype> output;
+    std::span<ddtype> outerDefault;
+    mutable std::vector<std::span<ddtype>> laneInputs; // each and sum: the views of the lane being run
+};
+
+// one voice of polyphonic rendering (WaviateFlow2025AudioProcessor::setPolyphonic): the plan's state
+// once more, a field and the steps over it, and the UserInput the voice plays from. see Runner::runVoice
+struct VoiceState {
+    std::vector<union ddtype, AlignedAllocator<union ddtype>> field;
+    std::vector<PlanStep> plan;
+    std::vector<PlanConversion> conversions;
+    std::shared_ptr<struct UserInput> input; // its own note only, kept by the processor
+};
+
 class RunnerInput {
 public:
     virtual ~RunnerInput() = default; // makes it polymorphic
     std::vector<std::unique_ptr<NodeData>> nodeCopies;
-    std::vector<union ddtype> field;
+    // laid out by Runner::initialize: values the plan never writes first, then an arena that step
+    // outputs share by liveness. slices start on cache lines
+    std::vector<union ddtype, AlignedAllocator<union ddtype>> field;
     std::vector<class NodeData*> nodesOrder;
+    std::vector<PlanStep> plan;             // block-rate steps, then per-sample steps shared by both channels, then per-channel ones
+    std::vector<PlanInput> planInputs;
+    std::vector<PlanConversion> planConversions;
+    int firstSampleRateStep = 0;
+    int firstChannelStep = 0;
+    bool dependsOnChannel = false;          // has per-channel steps, left and right may differ
+    // the per-frame steps regrouped into independent tasks: task t is steps [frameTasks[t], frameTasks[t + 1]),
+    // what joins them runs from frameTasks.back() to firstChannelStep. empty when the frame is too light to
+    // be worth handing off, see Runner::runSampleRate
+    std::vector<int> frameTasks;
+    // opt-in pipelined rendering (WaviateFlow2025AudioProcessor::setPipelined), set pipelined before
+    // Runner::initialize. the per-frame steps before pipelineCut then also run a block ahead on
+    // pipelineField, through pipelinePlan (which carries its own copy of the block-rate steps), and what
+    // the rest reads from them crosses over through pipelineBoundary. -1 when the frame wasn't split
+    bool pipelined = false;
+    int pipelineCut = -1;
+    std::vector<std::pair<int, int>> pipelineBoundary; // offset and size, the same in both fields
+    int pipelineBoundarySize = 0;
+    std::vector<union ddtype, AlignedAllocator<union ddtype>> pipelineField;
+    std::vector<PlanStep> pipelinePlan;
+    std::vector<PlanConversion> pipelineConversions;
+    static constexpr int maxPipelineBoundary = 64; // ddtypes per frame, the rest of the frame stays in one stage
+    // how long a released note's lane still sounds: the longest release of the envelopes in the plan
+    // (NodeType::laneRelease), nested runners included. the lanes stay active that long after note off
+    double laneReleaseSeconds = 0.0;
+    static constexpr double unknownLaneRelease = 10.0; // a release only known at run time
+    uint32_t inputReads = 0; // InputRead flags of the plan's steps, nested runners included
+    // the furthest back the plan reads the output histories (NodeType::historyLength), at most
+    // CIRCLEBUFFER_CAPACITY. the processor hands the runner storage for that many frames per channel,
+    // rounded up to a power of two: left, then right. shared by runners of the same size
+    int historyLength = 0;
+    std::shared_ptr<std::vector<double>> histories;
+    // polyphonic rendering, set numVoices before Runner::initialize: one VoiceState per voice, each
+    // starting out as voiceField. none when the plan has state outside field (the voices run side by
+    // side), the runner plays as one then
+    int numVoices = 0;
+    std::vector<VoiceState> voices;
+    std::vector<union ddtype, AlignedAllocator<union ddtype>> voiceField;
+    std::span<ddtype> outputSpan;
     std::unordered_map<NodeData*, std::span<ddtype>> nodeOwnership;
     std::unordered_map<NodeData*, std::tuple<int, int>> safeOwnership;
     std::unordered_set<NodeData*> compileTimeKnown;
     std::unordered_map<NodeData*, std::vector<ddtype>> nodeCompileTimeOutputs;
     std::unordered_map<NodeData*, NodeData*> remap;
+    int scenesInlined = 0;  // custom nodes whose graph was spliced into this one
+    int nodesMerged = 0;    // GraphOptimizer stats from the last initialize, nodesRemoved includes the merged ones
+    int nodesRemoved = 0;
+    std::map<std::string, int> rewriteCounts; // GraphOptimizer::simplify, per rule
+    size_t fieldBytesUnpacked = 0;  // field before and after the liveness packing
+    size_t fieldBytes = 0;
     std::string clangcode;
-    NodeFn compiledFunc;
-    OptLevel optLevel = OptLevel::medium;
+    mutable std::vector<ddtype*> clangInputPtrs; // runClang scratch, sized by Runner::initialize
+    mutable std::vector<int> clangInputSizes;
+    std::string kernelName;               // symbol of the kernel clangcode defines
+    std::atomic<NodeFn> compiledFunc{ nullptr }; // set once RunnerCompiler is done, the run* entry points switch over then
+    OptLevel optLevel = OptLevel::medium; // set before Runner::initialize, kernelName carries it
     NodeData* outputNode = nullptr;
+    // where the values of live nodes (NodeType::liveValues) sit in field, by the scene's node. one
+    // scene node can have several when its scene is inlined more than once
+    std::unordered_multimap<const NodeData*, std::pair<int, int>> liveSlots;
+    // the custom nodes in the plan that weren't inlined, each with an instance of its own of the compiled
+    // sub-scene (NodeData::optionalRunnerInput) so no two of them step the same field. filled in by their
+    // size queries as the plan is built, see SceneData::editNodeType and Runner::instantiate
+    mutable std::unordered_map<const NodeData*, std::unique_ptr<RunnerInput>> subRunners;
+    std::shared_ptr<const RunnerInput> instanceOf; // an instance: the compiled sub-scene whose plan it runs
 };
\ No newline at end of file
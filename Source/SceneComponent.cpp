@@ -36,15 +36,56 @@ SceneComponent::~SceneComponent()
 	drawReady = false;
 }
 
-void SceneComponent::onSceneChanged()
+static bool sameInterface(const std::vector<InputFeatures>& a, const std::vector<InputFeatures>& b)
 {
-    processorRef->initializeAllScenes();
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].name != b[i].name || a[i].inputType != b[i].inputType || a[i].requiredSize != b[i].requiredSize
+            || a[i].requiresCompileTimeKnowledge != b[i].requiresCompileTimeKnowledge) return false;
+    }
+    return true;
+}
+
+void SceneComponent::onSceneChanged(NodeData* edited)
+{
+    // the custom node type before any compile, parents compile against it
     computeAllNodeWildCards();
     ensureNodeConnectionsCorrect(this);
-    processorRef->initializeRunner();
-
+    const std::vector<InputFeatures> interfaceBefore = customNodeType.inputs;
     editNodeType();
 
+    // this scene always rebuilds. a dangling node, say, leaves what the scenes embedding it see as it
+    // was, so they only follow when the output or the inputs moved
+    markStructureChanged();
+    const bool parentsToo = !edited || feedsOutput(edited) || !sameInterface(interfaceBefore, customNodeType.inputs);
+    if (processorRef->initializeScenesAffectedBy(this, parentsToo)) processorRef->initializeRunner();
+    if (auto* editor = processorRef->getCurrentEditor(); editor && processorRef->getActiveScene() == this) {
+        editor->setActiveScene(this); // the compile stats
+    }
+
+    repaint();
+}
+
+void SceneComponent::onLiveValuesChanged(NodeData* node)
+{
+    // the first edit finds no slot, it recompiles the node out of the constants and into one
+    node->editedLive = true;
+    auto type = node->getType();
+    std::vector<ddtype> values;
+    if (type->liveValues == NodeType::LiveValues::table) {
+        values = node->optionalStoredAudio;
+    }
+    else {
+        // output nodes take no inputs, their value is whatever execute makes of the properties
+        values.resize(std::max(0, type->getOutputSize({}, {}, *this, 0, *node)));
+        type->execute(*node, *processorRef->dummyInput, {}, values, *this);
+    }
+    if (!processorRef->pushLiveValues(node, values)) {
+        onSceneChanged(node);
+        return;
+    }
+    // nothing recompiles now, but the next compile of anything holding this scene has to see it
+    markStructureChanged();
     repaint();
 }
 
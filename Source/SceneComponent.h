@@ -23,7 +23,12 @@ public:
     SceneComponent(class WaviateFlow2025AudioProcessor& processor, const uint64_t userId, const uint64_t nodeId);
     ~SceneComponent();
 
-    void onSceneChanged();
+    // edited is the node whose settings or inputs changed, null when it's not that simple (a node
+    // added or deleted). plans are only rebuilt if the edit can reach the scene's output
+    void onSceneChanged(class NodeData* edited = nullptr);
+    // a live node's values changed (NodeType::liveValues): handed straight to the audio thread when
+    // the playing runner can take them, through onSceneChanged otherwise
+    void onLiveValuesChanged(NodeData* node);
 
 	void constructWithName(const std::string& name) override;
 
@@ -12,6 +12,9 @@
 #include "NodeComponent.h"
 #include "Runner.h"
 #include "SceneComponent.h"
+#include <algorithm>
+
+std::recursive_mutex SceneData::compileLock;
 
 void SceneData::computeAllNodeWildCards() {
     for (auto& nc : nodeDatas) {
@@ -107,6 +110,7 @@ void SceneData::editNodeType()
     customNodeType.inputs.clear();
     std::vector<NodeData*> nodesFilteredByInputAndSorted;
 	getSortedInputNodes(nodesFilteredByInputAndSorted);
+    sortedInputNodes = nodesFilteredByInputAndSorted;
 
 
     for (int inputIdx = 0; inputIdx < nodesFilteredByInputAndSorted.size(); inputIdx++) {
@@ -148,8 +152,10 @@ void SceneData::editNodeType()
     //}
 
     customNodeType.execute = [](const NodeData& node, UserInput& userInput, const std::vector<std::span<ddtype>>& inputs, std::span<ddtype> output, const RunnerInput& inlineInstance) {
-        auto span = Runner::run(node.optionalRunnerInput.get(), userInput, inputs);
-        for (int i = 0; i < output.size(); i += 1) {
+        // this plan's own instance, never the shared one
+        auto it = inlineInstance.subRunners.find(&node);
+        auto span = Runner::run(it != inlineInstance.subRunners.end() ? it->second.get() : nullptr, userInput, inputs);
+        for (int i = 0; i < output.size() && i < span.size(); i += 1) {
             output[i] = span[i];
         }
     };
@@ -167,13 +173,12 @@ void SceneData::editNodeType()
                 outerInputs.emplace_back(const_cast<ddtype*>(v.data()), v.size());
             }
 
-            // Ensure the wrapper node has its sub-runner initialized
-
+            // shared with every other instance fed the same shapes, only compiled on a miss. the plan
+            // asking runs an instance of its own
+            self.optionalRunnerInput = compiledFor(outerInputs);
+            outerRunner.subRunners[&self] = Runner::instantiate(self.optionalRunnerInput);
             RunnerInput& subRunner = *self.optionalRunnerInput;
 
-            // Inline/compile the scene graph into this runner (SceneData::this)
-            Runner::initialize(subRunner,dynamic_cast<SceneComponent*>(this),outerInputs);
-
             // Ask the *sub-runner’s* output node for its size
             if (subRunner.outputNode) {
                 return subRunner.outputNode->getCompileTimeSize(&subRunner);
@@ -183,6 +188,78 @@ void SceneData::editNodeType()
 
 }
 
+std::shared_ptr<RunnerInput> SceneData::compiledFor(const std::vector<std::span<ddtype>>& outerInputs)
+{
+    std::lock_guard<std::recursive_mutex> guard(compileLock);
+    std::vector<int64_t> versions;
+    std::vector<const SceneData*> seen;
+    appendVersions(versions, seen);
+    if (versions != compiledVersions) {
+        // instances still held by the plans playing right now stay alive through their shared_ptr
+        compiledInstances.clear();
+        compiledVersions = versions;
+    }
+
+    std::vector<int64_t> key;
+    for (size_t i = 0; i < outerInputs.size(); ++i) {
+        key.push_back((int64_t)outerInputs[i].size());
+        if (i < customNodeType.inputs.size() && customNodeType.inputs[i].requiresCompileTimeKnowledge) {
+            for (const ddtype& v : outerInputs[i]) key.push_back(v.i);
+        }
+    }
+
+    auto& compiled = compiledInstances[key];
+    if (!compiled) {
+        compiled = std::make_shared<RunnerInput>();
+        Runner::initialize(*compiled, dynamic_cast<SceneComponent*>(this), outerInputs);
+    }
+    return compiled;
+}
+
+void SceneData::markStructureChanged()
+{
+    ++structureVersion;
+}
+
+bool SceneData::feedsOutput(const NodeData* node) const
+{
+    if (nodeDatas.empty() || !node) return false;
+    // same pick as Runner's storeCopies
+    const NodeData* output = nodeDatas[0];
+    for (NodeData* n : nodeDatas) {
+        if (n->getType()->name == "output") { output = n; break; }
+    }
+
+    std::unordered_set<const NodeData*> visited{ node };
+    std::vector<const NodeData*> stack{ node };
+    while (!stack.empty()) {
+        const NodeData* current = stack.back();
+        stack.pop_back();
+        if (current == output) return true;
+        for (const auto& [consumer, idx] : current->outputs) {
+            if (consumer && visited.insert(consumer).second) stack.push_back(consumer);
+        }
+    }
+    return false;
+}
+
+bool SceneData::inputOrderChanged()
+{
+    std::vector<NodeData*> sorted;
+    getSortedInputNodes(sorted);
+    return sorted != sortedInputNodes;
+}
+
+void SceneData::appendVersions(std::vector<int64_t>& versions, std::vector<const SceneData*>& seen) const
+{
+    if (std::find(seen.begin(), seen.end(), this) != seen.end()) return;
+    seen.push_back(this);
+    versions.push_back((int64_t)structureVersion);
+    for (NodeData* node : nodeDatas) {
+        if (auto sub = node->getType()->fromScene) sub->appendVersions(versions, seen);
+    }
+}
+
 const std::string& SceneData::getSceneName() const { return (std::string&)sceneName; }
 
 void SceneData::setSceneName(const std::string& newName)
@@ -10,6 +10,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <map>
+#include <span>
+#include <mutex>
 #include "RunnerInput.h"
 #include "NodeType.h"
 #pragma once
@@ -29,6 +32,22 @@ public:
     void computeAllNodeWildCards();
     NodeType customNodeType;
     void editNodeType();
+    // this scene compiled as a custom node for the given outer inputs. memoized on their shapes (and
+    // the values of compile-time inputs), every instance of the custom node shares the result until
+    // this scene or one nested in it changes
+    std::shared_ptr<RunnerInput> compiledFor(const std::vector<std::span<ddtype>>& outerInputs);
+    // held while a compile reads or sizes a scene's nodes from outside that scene's own initialize,
+    // scenes compile concurrently (see WaviateFlow2025AudioProcessor::initializeScenes). one for every
+    // scene: compiledFor nests into the scenes it embeds, and two scenes embedding each other would take
+    // per-scene locks in opposite orders. recursive since a scene can end up inside itself
+    static std::recursive_mutex compileLock;
+    // bumps structureVersion, the compiled instances are rebuilt on next use
+    void markStructureChanged();
+    // whether the output node depends on node, following outputs downstream
+    bool feedsOutput(const NodeData* node) const;
+    // whether moving input nodes reordered the custom node's inputs since the last editNodeType
+    bool inputOrderChanged();
+    uint64_t structureVersion = 0;
 	const std::string& getSceneName() const;
 	void setSceneName(const std::string& newName);
     bool isLocalOnly;
@@ -36,5 +55,9 @@ public:
     bool isLocalEditable();
 private:
     std::string sceneName;
+    void appendVersions(std::vector<int64_t>& versions, std::vector<const SceneData*>& seen) const;
+    std::vector<NodeData*> sortedInputNodes; // as of the last editNodeType
+    std::vector<int64_t> compiledVersions; // of this scene and the ones nested in it, when compiledInstances was filled
+    std::map<std::vector<int64_t>, std::shared_ptr<RunnerInput>> compiledInstances;
     SceneData();
 };
\ No newline at end of file
@@ -16,6 +16,13 @@ ScenePropertiesComponent::ScenePropertiesComponent(WaviateFlow2025AudioProcessor
     addAndMakeVisible(addressLabel);
     addAndMakeVisible(addressEditor);
     addAndMakeVisible(publishToMarketplaceButton);
+    addAndMakeVisible(pipelineToggle);
+    addAndMakeVisible(polyphonyToggle);
+    addAndMakeVisible(smoothingToggle);
+    addAndMakeVisible(voiceLimitLabel);
+    addAndMakeVisible(voiceLimitSlider);
+    addAndMakeVisible(statsLabel);
+    voiceLimitSlider.setRange(1, WaviateFlow2025AudioProcessor::maxVoices, 1);
 
     attachCallbacks();
 
@@ -30,6 +37,9 @@ void ScenePropertiesComponent::configureLookAndFeel()
     // Labels
     nameLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     addressLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    voiceLimitLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    statsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    statsLabel.setJustificationType(juce::Justification::topLeft);
 
     // Editors
     nameEditor.setColour(juce::TextEditor::backgroundColourId, background.brighter(0.1f));
@@ -46,6 +56,20 @@ void ScenePropertiesComponent::configureLookAndFeel()
     publishToMarketplaceButton.setColour(juce::TextButton::buttonColourId, accent);
     publishToMarketplaceButton.setColour(juce::TextButton::textColourOnId, juce::Colours::black);
     publishToMarketplaceButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+
+    // Toggle
+    pipelineToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    pipelineToggle.setColour(juce::ToggleButton::tickColourId, accent);
+    pipelineToggle.setColour(juce::ToggleButton::tickDisabledColourId, juce::Colours::grey);
+    polyphonyToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    polyphonyToggle.setColour(juce::ToggleButton::tickColourId, accent);
+    polyphonyToggle.setColour(juce::ToggleButton::tickDisabledColourId, juce::Colours::grey);
+    smoothingToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    smoothingToggle.setColour(juce::ToggleButton::tickColourId, accent);
+
+    // Slider
+    voiceLimitSlider.setColour(juce::Slider::textBoxTextColourId, juce::Colours::white);
+    voiceLimitSlider.setColour(juce::Slider::textBoxOutlineColourId, accent);
 }
 
 void ScenePropertiesComponent::attachCallbacks()
@@ -84,6 +108,28 @@ void ScenePropertiesComponent::attachCallbacks()
                 );
             }
         };
+
+    // not per scene: it's how the plugin plays whichever scene is audible
+    pipelineToggle.onClick = [this]
+        {
+            processor.setPipelined(pipelineToggle.getToggleState());
+        };
+
+    polyphonyToggle.onClick = [this]
+        {
+            processor.setPolyphonic(polyphonyToggle.getToggleState());
+            updateProperties();
+        };
+
+    smoothingToggle.onClick = [this]
+        {
+            processor.setLiveSmoothing(smoothingToggle.getToggleState() ? WaviateFlow2025AudioProcessor::defaultLiveSmoothingSeconds : 0.0);
+        };
+
+    voiceLimitSlider.onValueChange = [this]
+        {
+            processor.setVoiceLimit((int)voiceLimitSlider.getValue());
+        };
 }
 
 void ScenePropertiesComponent::setActiveScene(SceneComponent* scene)
@@ -94,6 +140,12 @@ void ScenePropertiesComponent::setActiveScene(SceneComponent* scene)
 
 void ScenePropertiesComponent::onUpdateUI()
 {
+    pipelineToggle.setToggleState(processor.isPipelined(), juce::dontSendNotification);
+    polyphonyToggle.setToggleState(processor.isPolyphonic(), juce::dontSendNotification);
+    smoothingToggle.setToggleState(processor.getLiveSmoothing() > 0.0, juce::dontSendNotification);
+    voiceLimitSlider.setValue(processor.getVoiceLimit(), juce::dontSendNotification);
+    voiceLimitSlider.setEnabled(processor.isPolyphonic());
+    pipelineToggle.setEnabled(!processor.isPolyphonic()); // voices take over from the pipeline
     if (activeSceneData)
     {
         nameEditor.setText(activeSceneData->getSceneName(), juce::dontSendNotification);
@@ -106,9 +158,26 @@ void ScenePropertiesComponent::onUpdateUI()
         bool hasReachedPublishLimit = false; // Placeholder for actual limit check
         bool canPublish = authed && !hasReachedPublishLimit;
         publishToMarketplaceButton.setEnabled(canPublish);
+
+        const RunnerInput& compiled = *activeSceneData;
+        juce::String stats;
+        stats << "Inlined " << compiled.scenesInlined << " scenes, merged " << compiled.nodesMerged
+              << " nodes, removed " << compiled.nodesRemoved << "\n";
+        stats << "Field " << juce::String(compiled.fieldBytes / 1024.0, 1) << " of "
+              << juce::String(compiled.fieldBytesUnpacked / 1024.0, 1) << " KiB after packing\n";
+        juce::StringArray rewrites;
+        for (const auto& [rule, count] : compiled.rewriteCounts) {
+            rewrites.add(juce::String(rule) + " " + juce::String(count));
+        }
+        stats << "Rewrites: " << (rewrites.isEmpty() ? juce::String("none") : rewrites.joinIntoString(", "));
+        if (const int dropped = processor.getDroppedMidiEventCount()) {
+            stats << "\nMIDI events dropped while pipelined: " << dropped;
+        }
+        statsLabel.setText(stats, juce::dontSendNotification);
     }
     else
     {
+        statsLabel.setText({}, juce::dontSendNotification);
         nameEditor.clear();
         addressEditor.clear();
         nameEditor.setEnabled(false);
@@ -147,6 +216,17 @@ void ScenePropertiesComponent::resized()
     addressLabel.setBounds(row.removeFromLeft(labelWidth));
     addressEditor.setBounds(row);
 
+    area.removeFromTop(spacing);
+    pipelineToggle.setBounds(area.removeFromTop(rowHeight));
+    polyphonyToggle.setBounds(area.removeFromTop(rowHeight));
+    row = area.removeFromTop(rowHeight);
+    voiceLimitLabel.setBounds(row.removeFromLeft(labelWidth));
+    voiceLimitSlider.setBounds(row.removeFromLeft(120));
+    smoothingToggle.setBounds(area.removeFromTop(rowHeight));
+
     area.removeFromTop(spacing * 2);
     publishToMarketplaceButton.setBounds(area.removeFromTop(rowHeight).reduced(0, 4));
+
+    area.removeFromTop(spacing);
+    statsLabel.setBounds(area.removeFromTop(rowHeight * 3));
 }
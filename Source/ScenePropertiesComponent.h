@@ -17,8 +17,14 @@ private:
     juce::TextEditor nameEditor;
     juce::TextEditor addressEditor;
     juce::TextButton publishToMarketplaceButton{ "Publish" };
+    juce::ToggleButton pipelineToggle{ "Pipelined rendering (one block of latency)" };
+    juce::ToggleButton polyphonyToggle{ "Polyphonic (an instance per note)" };
+    juce::ToggleButton smoothingToggle{ "Glide live edits (20 ms)" };
+    juce::Slider voiceLimitSlider{ juce::Slider::IncDecButtons, juce::Slider::TextBoxLeft };
+    juce::Label voiceLimitLabel{ {}, "Voices:" };
     juce::Label nameLabel{ {}, "Name:" };
     juce::Label addressLabel{ {}, "Menu Address:" };
+    juce::Label statsLabel; // what the last compile of the scene made of it
     WaviateFlow2025AudioProcessor& processor;
 
     // Inherited via PropertiesMenu
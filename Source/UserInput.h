@@ -9,7 +9,7 @@
 */
 #pragma once
 #define MIDI_NOTE_COUNT 128
-#define CIRCLEBUFFER_CAPACITY 480000
+#define CIRCLEBUFFER_CAPACITY 480000 // the furthest back a plan can look, and how far when it's only known at run time
 #define DAW_PARAM_SIZE 1024
 #include "StringifyDefines.h"
 
@@ -22,10 +22,11 @@ DEFINE_AND_CREATE_VAR(
 static inline void CircleBuffer_add(double* data,
     int* head,
     int* count,
+    int mask,
     double value) {
     data[*head] = value;
-    *head = (*head + 1) % CIRCLEBUFFER_CAPACITY;
-    if (*count < CIRCLEBUFFER_CAPACITY) {
+    *head = (*head + 1) & mask;
+    if (*count <= mask) {
         (*count)++;
     }
 }
@@ -34,19 +35,15 @@ static inline int CircleBuffer_size(const int* count) {
     return *count;
 }
 
-static inline int CircleBuffer_capacity(void) {
-    return CIRCLEBUFFER_CAPACITY;
-}
-
 static inline double CircleBuffer_get(const double* data,
     const int head,
     const int count,
+    const int mask,
     int indexAgo) {
-    if (indexAgo >= count) {
+    if (indexAgo >= count || indexAgo < 0) {
         return 0.0;
     }
-    int idx = (head + CIRCLEBUFFER_CAPACITY - 1 - indexAgo) % CIRCLEBUFFER_CAPACITY;
-    return data[idx];
+    return data[(head - 1 - indexAgo) & mask];
 }
 
 typedef struct UserInput
@@ -58,6 +55,11 @@ typedef struct UserInput
     double controllerValues[MIDI_NOTE_COUNT];
     double noteHz[MIDI_NOTE_COUNT];
     double noteCycle[MIDI_NOTE_COUNT];
+    // the lanes of the 128-wide note vectors that sound this sub-block, ascending: held notes and released
+    // ones still within the runners' release (WaviateFlow2025AudioProcessor::updateActiveLanes). the
+    // lane-sparse steps only compute these, see PlanStep::lanes
+    int activeLanes[MIDI_NOTE_COUNT];
+    int numActiveLanes;
     double dawParams[DAW_PARAM_SIZE];
     int midiCCValues[MIDI_NOTE_COUNT];
     double pitchWheelValue;
@@ -78,12 +80,15 @@ typedef struct UserInput
     int timeSigTop;
     int timeSigBottom;
     double BPM;
-    double leftInputHistoryArray[CIRCLEBUFFER_CAPACITY];
+    // the output of the last historyMask + 1 frames of each channel, a power of two. the storage is the
+    // processor's, sized by the runners playing (RunnerInput::historyLength), null when none reads it
+    double* leftInputHistoryArray;
     int leftInputHistoryHead;
     int leftInputHistorySize;
-    double rightInputHistoryArray[CIRCLEBUFFER_CAPACITY];
+    double* rightInputHistoryArray;
     int rightInputHistoryHead;
     int rightInputHistorySize;
+    int historyMask;
     //double getHistoricalSample(int samplesAgo) const;
     //std::unordered_map<juce::String, double> namedValues;
     //std::unordered_map<int, double> storeableValues;
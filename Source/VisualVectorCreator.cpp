@@ -73,7 +73,7 @@ void VisualVectorCreator::setCapacity(double newCapacity)
     node.getNodeData().setProperty("size", capacity);
 
     if (auto* scene = node.getOwningScene())
-        scene->onSceneChanged();
+        scene->onSceneChanged(&node.getNodeData());
 
     repaint();
 }
@@ -206,7 +206,7 @@ void VisualVectorCreator::mouseDrag(const juce::MouseEvent& e)
 
     if (changed) {
         if (auto* scene = node.getOwningScene())
-            scene->onSceneChanged();
+            scene->onLiveValuesChanged(&node.getNodeData());
         repaint();
     }
 }
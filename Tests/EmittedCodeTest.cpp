@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    EmittedCodeTest.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Runner.h"
+
+#if WAVIATE_JIT
+#include "../Source/PluginProcessor.h"
+#include "../Source/SceneComponent.h"
+#include "../Source/NodeComponent.h"
+#include "../Source/NodeData.h"
+
+// the C a runner is emitted as has to play what its plan plays. every node type of the registry on its
+// own in front of an output: the scene is initialized twice, one of them gets its kernel compiled and
+// the two are run side by side on the same input. types the interpreter can't take on their own, or
+// that emit no C, are counted and left out
+class EmittedCodeTest : public juce::UnitTest {
+public:
+    EmittedCodeTest() : juce::UnitTest("emitted C matches the interpreter", "Waviate") {}
+
+    void runTest() override
+    {
+        beginTest("every registry type");
+
+        WaviateFlow2025AudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, 256);
+
+        int compared = 0, notInitialized = 0, noSource = 0;
+        for (size_t t = 0; t < processor.registry.size(); ++t) {
+            const NodeType& type = processor.registry[t];
+            if (type.fromScene || type.isNondeterministic || type.isInputNode || type.name == "output") continue;
+
+            processor.addScene("probe " + type.name);
+            SceneComponent* scene = processor.scenes.back().get();
+            scene->addNode(type, { 200, 500 }, scene->nodeDatas[0], 0);
+
+            RunnerInput interpreted, compiled;
+            try {
+                Runner::initialize(interpreted, scene, {});
+                Runner::initialize(compiled, scene, {});
+            }
+            catch (const std::exception&) {
+                ++notInitialized;
+                processor.deleteScene(scene);
+                continue;
+            }
+            if (compiled.clangcode.empty() || compiled.nodeCopies.empty()) {
+                ++noSource;
+                processor.deleteScene(scene);
+                continue;
+            }
+
+            NodeFn kernel = Runner::compileKernel(compiled.clangcode, compiled.kernelName, compiled.optLevel);
+            expect(kernel != nullptr, type.name + ": the emitted C doesn't compile");
+            if (kernel) {
+                compiled.compiledFunc.store(kernel, std::memory_order_release);
+                compare(type.name, interpreted, compiled);
+                ++compared;
+            }
+            processor.deleteScene(scene);
+        }
+        logMessage(juce::String(compared) + " types compared, " + juce::String(noSource) + " without C, "
+            + juce::String(notInitialized) + " that don't initialize on their own");
+        expect(compared > 0, "no type was compared");
+    }
+
+private:
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int frames = 256;
+    static constexpr int subBlock = 64;
+
+    // both channels of every frame, block-rate steps every subBlock frames, a note held from the start
+    void compare(const juce::String& name, RunnerInput& interpreted, RunnerInput& compiled)
+    {
+        auto inputA = makeInput(), inputB = makeInput();
+        for (int frame = 0; frame < frames; ++frame) {
+            for (UserInput* input : { inputA.get(), inputB.get() }) {
+                input->sampleInBlock = frame % subBlock;
+                input->numFramesStartOfBlock = frame - frame % subBlock;
+                input->leftInput = std::sin(frame * 0.05);
+                input->rightInput = std::cos(frame * 0.05);
+            }
+            if (frame % subBlock == 0) {
+                Runner::runBlockRate(&interpreted, *inputA);
+                Runner::runBlockRate(&compiled, *inputB);
+            }
+            Runner::runSampleRate(&interpreted, *inputA);
+            Runner::runSampleRate(&compiled, *inputB);
+            for (bool right : { false, true }) {
+                inputA->isStereoRight = inputB->isStereoRight = right;
+                std::span<ddtype> a = Runner::runChannel(&interpreted, *inputA);
+                std::span<ddtype> b = Runner::runChannel(&compiled, *inputB);
+                expectEquals((int)b.size(), (int)a.size(), name + ": output sizes differ");
+                for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+                    if (!close(a[i].d, b[i].d)) {
+                        expect(false, name + ": frame " + juce::String(frame) + " plays " + juce::String(a[i].d)
+                            + " interpreted and " + juce::String(b[i].d) + " compiled");
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    // the C compiler is free to contract and reorder, so not bit for bit
+    static bool close(double a, double b)
+    {
+        if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+        if (a == b) return true;
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+    }
+
+    static std::unique_ptr<UserInput> makeInput()
+    {
+        auto input = std::make_unique<UserInput>();
+        input->sampleRate = sampleRate;
+        input->BPM = 120.0;
+        input->notesOn[60] = 1.0;
+        input->noteVelocity[60] = 0.8;
+        input->noteHz[60] = 261.6255653;
+        for (int n = 0; n < MIDI_NOTE_COUNT; ++n) input->activeLanes[n] = n;
+        input->numActiveLanes = MIDI_NOTE_COUNT;
+        return input;
+    }
+};
+
+static EmittedCodeTest emittedCodeTest;
+#endif
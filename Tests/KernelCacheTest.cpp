@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    KernelCacheTest.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Runner.h"
+
+#if WAVIATE_JIT
+#include "../Source/KernelCache.h"
+
+namespace {
+    // a kernel no earlier run can have cached: the name is new every time, and it's part of the source
+    std::string probeSource(const std::string& funcName)
+    {
+        return "typedef union { double d; long long i; } ddtype;\n"
+            "struct UserInput;\n"
+            "void " + funcName + "(ddtype* dataField, int dataFieldSize, ddtype* output, int outputSize,\n"
+            "    ddtype** inputs, int* inputSizes, int numInputs, struct UserInput* u, int group)\n"
+            "{\n"
+            "    (void)dataField; (void)dataFieldSize; (void)inputs; (void)inputSizes; (void)numInputs; (void)u;\n"
+            "    for (int i = 0; i < outputSize; ++i) output[i].d = 2.5 * i + group;\n"
+            "}\n";
+    }
+
+    bool probePlays(NodeFn kernel)
+    {
+        if (!kernel) return false;
+        ddtype output[4];
+        kernel(nullptr, 0, output, 4, nullptr, nullptr, 0, nullptr, 1);
+        for (int i = 0; i < 4; ++i) {
+            if (output[i].d != 2.5 * i + 1) return false;
+        }
+        return true;
+    }
+}
+
+// the child half of KernelCacheTest, see Main.cpp: a fresh process compiling the kernel the test
+// compiled before has to get it from the cache. exit code 0 when it did and the kernel plays
+int runKernelCacheProbe(const juce::String& funcName)
+{
+    const int hitsBefore = KernelCache::get().getHits();
+    NodeFn kernel = Runner::compileKernel(probeSource(funcName.toStdString()), funcName.toStdString(), OptLevel::medium);
+    if (KernelCache::get().getHits() != hitsBefore + 1) return 1;
+    return probePlays(kernel) ? 0 : 2;
+}
+
+// a kernel compiled once is written to the cache, and a later session compiling the same source loads
+// it back instead of running clang. within one process the JIT already has the symbol, so the second
+// compile runs in a child process of the test executable
+class KernelCacheTest : public juce::UnitTest {
+public:
+    KernelCacheTest() : juce::UnitTest("kernels are cached across processes", "Waviate") {}
+
+    void runTest() override
+    {
+        beginTest("one write, one read from a fresh process");
+
+        const std::string funcName = "kernelCacheProbe_" + juce::Uuid().toString().toStdString();
+        const int storesBefore = KernelCache::get().getStores();
+        NodeFn kernel = Runner::compileKernel(probeSource(funcName), funcName, OptLevel::medium);
+        expect(probePlays(kernel), "the probe kernel plays wrong");
+        expectEquals(KernelCache::get().getStores(), storesBefore + 1, "the kernel wasn't written to the cache");
+
+        juce::ChildProcess child;
+        const juce::StringArray args{ juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName(),
+            "--kernel-cache-probe", juce::String(funcName) };
+        expect(child.start(args), "couldn't start the probe process");
+        const juce::String output = child.readAllProcessOutput();
+        expect(child.waitForProcessToFinish(60000), "the probe process didn't finish");
+        expectEquals((int)child.getExitCode(), 0, "the fresh process didn't load the kernel from the cache: " + output);
+    }
+};
+
+static KernelCacheTest kernelCacheTest;
+#endif
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Runner.h"
+
+#if WAVIATE_JIT
+int runKernelCacheProbe(const juce::String& funcName); // KernelCacheTest.cpp
+#endif
+
+// runs every test of the "Waviate" category, the exit code is the number of failed tests (capped).
+// tests that need a process of their own start this executable again with a flag
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI gui; // headless, but scenes are components
+#if WAVIATE_JIT
+    if (argc == 3 && juce::String(argv[1]) == "--kernel-cache-probe") return runKernelCacheProbe(argv[2]);
+#else
+    juce::ignoreUnused(argc, argv);
+#endif
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("Waviate");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i) {
+        failures += runner.getResult(i)->failures;
+    }
+    return juce::jmin(failures, 125);
+}
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    RealtimeCheckTest.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/RealtimeCheck.h"
+
+#if WAVIATE_REALTIME_CHECKS
+#include "../Source/PluginProcessor.h"
+#include "../Source/SceneComponent.h"
+#include "../Source/NodeComponent.h"
+#include "../Source/NodeData.h"
+
+// the realtime contract as a test: blocks of a scene holding a custom node through processBlock, with
+// notes, controllers and the pitch wheel coming in, and a recompile half-way whose runner the audio
+// thread picks up and crossfades to, must not allocate or lock. once for every way the processor
+// renders
+class RealtimeCheckTest : public juce::UnitTest {
+public:
+    RealtimeCheckTest() : juce::UnitTest("audio thread stays realtime safe", "Waviate") {}
+
+    void runTest() override
+    {
+        beginTest("processBlock");
+        playScene(false, false);
+        beginTest("processBlock, pipelined");
+        playScene(true, false);
+        beginTest("processBlock, polyphonic");
+        playScene(false, true);
+    }
+
+private:
+    static const NodeType* findType(const WaviateFlow2025AudioProcessor& processor, const char* name)
+    {
+        for (const NodeType& type : processor.registry) {
+            if (type.name == name) return &type;
+        }
+        return nullptr;
+    }
+
+    void playScene(bool pipelined, bool polyphonic)
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 256;
+
+        WaviateFlow2025AudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.setPipelined(pipelined);
+        processor.setPolyphonic(polyphonic);
+
+        const NodeType* waveCycle = findType(processor, "wave cycle");
+        const NodeType* envelope = findType(processor, "envelope (ADSR)");
+        const NodeType* multiply = findType(processor, "multiply");
+        const NodeType* add = findType(processor, "add");
+        const NodeType* pitchWheel = findType(processor, "pitch wheel");
+        expect(waveCycle && envelope && multiply && add && pitchWheel, "node types missing from the registry");
+        if (!waveCycle || !envelope || !multiply || !add || !pitchWheel) return;
+
+        // a sub-scene of its own, played as a custom node: main's output <- multiply(voice, envelope)
+        processor.addScene("voice");
+        SceneComponent* voice = processor.scenes.back().get();
+        voice->addNode(*waveCycle, { 200, 500 }, voice->nodeDatas[0], 0);
+
+        SceneComponent* main = processor.scenes[0].get();
+        NodeData& product = main->addNode(*multiply, { 300, 500 }, main->nodeDatas[0], 0).getNodeData();
+        main->addNode(voice->customNodeType, { 200, 400 }, &product, 0);
+        main->addNode(*envelope, { 200, 600 }, &product, 1);
+        processor.initializeRunner();
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        const int before = realtime::getViolationCount();
+        for (int block = 0; block < 24; ++block) {
+            midi.clear();
+            if (block % 4 == 0) {
+                midi.addEvent(juce::MidiMessage::noteOn(1, 60 + block / 4, 0.8f), 0);
+                midi.addEvent(juce::MidiMessage::noteOn(1, 64 + block / 4, 0.6f), blockSize / 3);
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 1, block * 5), blockSize / 2);
+            }
+            if (block % 4 == 2) {
+                midi.addEvent(juce::MidiMessage::pitchWheel(1, 8192 + block * 100), 10);
+                midi.addEvent(juce::MidiMessage::noteOff(1, 60 + block / 4), blockSize * 3 / 4);
+                midi.addEvent(juce::MidiMessage::noteOff(1, 64 + block / 4), blockSize - 1);
+            }
+            // a new runner to pick up and crossfade to: the pitch wheel added on top of the voice
+            if (block == 8) {
+                NodeData& sum = voice->addNode(*add, { 300, 500 }, voice->nodeDatas[0], 0).getNodeData();
+                voice->addNode(*waveCycle, { 200, 400 }, &sum, 0);
+                voice->addNode(*pitchWheel, { 200, 600 }, &sum, 1);
+            }
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+        }
+        expectEquals(realtime::getViolationCount() - before, 0, realtime::getLastViolation());
+
+        processor.releaseResources();
+    }
+};
+
+static RealtimeCheckTest realtimeCheckTest;
+#endif
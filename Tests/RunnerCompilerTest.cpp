@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    RunnerCompilerTest.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/Runner.h"
+
+#if WAVIATE_JIT
+#include "../Source/PluginProcessor.h"
+#include "../Source/SceneComponent.h"
+#include "../Source/NodeComponent.h"
+#include "../Source/NodeData.h"
+#include "../Source/RealtimeCheck.h"
+
+// a runner starts out interpreted, RunnerCompiler builds its kernel in the background and the audio
+// thread switches over in the middle of playing. the kernel has to arrive for the runner that is playing,
+// not one an edit replaced while it compiled, and playing on through the switch has to stay finite and
+// (in builds with the checks) realtime safe
+class RunnerCompilerTest : public juce::UnitTest {
+public:
+    RunnerCompilerTest() : juce::UnitTest("kernels are compiled and swapped in", "Waviate") {}
+
+    void runTest() override
+    {
+        beginTest("compile, then swap");
+
+        WaviateFlow2025AudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const NodeType* waveCycle = findType(processor, "wave cycle");
+        const NodeType* multiply = findType(processor, "multiply");
+        expect(waveCycle && multiply, "node types missing from the registry");
+        if (!waveCycle || !multiply) return;
+
+        // two edits in a row, the first runner's compile is superseded by the second's
+        SceneComponent* main = processor.scenes[0].get();
+        main->addNode(*waveCycle, { 200, 500 }, main->nodeDatas[0], 0);
+        NodeData& product = main->addNode(*multiply, { 300, 500 }, main->nodeDatas[0], 0).getNodeData();
+        main->addNode(*waveCycle, { 200, 400 }, &product, 0);
+        main->addNode(*waveCycle, { 200, 600 }, &product, 1);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 69, 1.0f), 0);
+        processor.processBlock(buffer, midi);
+        midi.clear();
+        const RunnerInput* playing = processor.getCurrentRunner();
+        expect(playing != nullptr, "no runner picked up");
+        if (!playing) return;
+        expect(playing->compiledFunc.load() == nullptr, "the kernel came before the compiler could have run");
+
+        const int before = realtime::getViolationCount();
+        const juce::uint32 deadline = juce::Time::getMillisecondCounter() + timeoutMs;
+        bool swapped = false;
+        while (!swapped && juce::Time::getMillisecondCounter() < deadline) {
+            juce::MessageManager::getInstance()->runDispatchLoopUntil(20);
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            expect(processor.getCurrentRunner() == playing, "the runner changed without an edit");
+            swapped = playing->compiledFunc.load() != nullptr;
+        }
+        expect(swapped, "the kernel never arrived");
+
+        // a few blocks on the kernel
+        for (int block = 0; block < 16; ++block) {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                for (int sample = 0; sample < blockSize; ++sample) {
+                    if (!std::isfinite(buffer.getSample(channel, sample))) {
+                        expect(false, "the kernel plays non-finite samples");
+                        channel = buffer.getNumChannels();
+                        break;
+                    }
+                }
+            }
+        }
+        expectEquals(realtime::getViolationCount() - before, 0, realtime::getLastViolation());
+
+        processor.releaseResources();
+    }
+
+private:
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 256;
+    static constexpr juce::uint32 timeoutMs = 60000; // a cold clang in a debug build is slow
+
+    static const NodeType* findType(const WaviateFlow2025AudioProcessor& processor, const char* name)
+    {
+        for (const NodeType& type : processor.registry) {
+            if (type.name == name) return &type;
+        }
+        return nullptr;
+    }
+};
+
+static RunnerCompilerTest runnerCompilerTest;
+#endif
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    SceneLoadTest.cpp
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/SceneComponent.h"
+#include "../Source/NodeComponent.h"
+#include "../Source/NodeData.h"
+#include "../Source/Runner.h"
+
+// loading a project compiles its scenes level by level, the scenes of a level on the pool at once
+// (WaviateFlow2025AudioProcessor::initializeScenes). here every scene of the top level embeds the same
+// two sub-scenes, one nested in the other, so their compiledFor caches are missed and filled from
+// several threads together. whatever the interleaving, every scene has to come out whole and play the same
+class SceneLoadTest : public juce::UnitTest {
+public:
+    SceneLoadTest() : juce::UnitTest("scenes sharing sub-scenes load in parallel", "Waviate") {}
+
+    void runTest() override
+    {
+        beginTest("initializeAllScenes");
+
+        WaviateFlow2025AudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(44100.0, 256);
+
+        const NodeType* waveCycle = findType(processor, "wave cycle");
+        const NodeType* multiply = findType(processor, "multiply");
+        const NodeType* add = findType(processor, "add");
+        expect(waveCycle && multiply && add, "node types missing from the registry");
+        if (!waveCycle || !multiply || !add) return;
+
+        // leaf: a wave cycle. squared: leaf * leaf. the parents: leaf + squared
+        processor.addScene("leaf");
+        SceneComponent* leaf = processor.scenes.back().get();
+        leaf->addNode(*waveCycle, { 200, 500 }, leaf->nodeDatas[0], 0);
+
+        processor.addScene("squared");
+        SceneComponent* squared = processor.scenes.back().get();
+        NodeData& product = squared->addNode(*multiply, { 300, 500 }, squared->nodeDatas[0], 0).getNodeData();
+        squared->addNode(leaf->customNodeType, { 200, 400 }, &product, 0);
+        squared->addNode(leaf->customNodeType, { 200, 600 }, &product, 1);
+
+        std::vector<SceneComponent*> parents;
+        for (int i = 0; i < numParents; ++i) {
+            processor.addScene("parent " + juce::String(i));
+            SceneComponent* parent = processor.scenes.back().get();
+            NodeData& sum = parent->addNode(*add, { 300, 500 }, parent->nodeDatas[0], 0).getNodeData();
+            parent->addNode(leaf->customNodeType, { 200, 400 }, &sum, 0);
+            parent->addNode(squared->customNodeType, { 200, 600 }, &sum, 1);
+            parents.push_back(parent);
+        }
+
+        for (int round = 0; round < rounds; ++round) {
+            // as good as a fresh load: every compile of the leaf, and so of squared, is out of date
+            leaf->markStructureChanged();
+            try {
+                processor.initializeAllScenes();
+            }
+            catch (const std::exception& e) {
+                expect(false, juce::String("initializeAllScenes threw: ") + e.what());
+                return;
+            }
+
+            std::vector<std::vector<double>> played;
+            for (SceneComponent* parent : parents) {
+                expect(parent->outputNode != nullptr, parent->getSceneName() + " has no output after loading");
+                if (!parent->outputNode) return;
+                played.push_back(play(parent));
+            }
+            for (size_t i = 1; i < played.size(); ++i) {
+                expect(played[i] == played[0], parents[i]->getSceneName() + " plays differently from " + parents[0]->getSceneName());
+            }
+        }
+    }
+
+private:
+    static constexpr int numParents = 6;
+    static constexpr int rounds = 20;
+    static constexpr int frames = 128;
+
+    static const NodeType* findType(const WaviateFlow2025AudioProcessor& processor, const char* name)
+    {
+        for (const NodeType& type : processor.registry) {
+            if (type.name == name) return &type;
+        }
+        return nullptr;
+    }
+
+    // the left channel of the scene's first frames, from a fresh input with a note held
+    static std::vector<double> play(SceneData* scene)
+    {
+        auto input = std::make_unique<UserInput>();
+        input->sampleRate = 44100.0;
+        input->notesOn[69] = 1.0;
+        input->noteVelocity[69] = 1.0;
+        input->noteHz[69] = 440.0;
+        std::vector<double> out;
+        Runner::runBlockRate(scene, *input);
+        for (int frame = 0; frame < frames; ++frame) {
+            input->sampleInBlock = frame;
+            input->isStereoRight = false;
+            Runner::runSampleRate(scene, *input);
+            std::span<ddtype> left = Runner::runChannel(scene, *input);
+            out.push_back(left.empty() ? 0.0 : left[0].d);
+        }
+        return out;
+    }
+};
+
+static SceneLoadTest sceneLoadTest;